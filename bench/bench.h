@@ -0,0 +1,27 @@
+/**
+ * @file bench.h
+ * @brief Timing helpers shared by the benchmarks.
+ */
+
+#ifndef STACK_BENCH_H
+#define STACK_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+// Returns the monotonic time in nanoseconds.
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+// Converts an operation count and elapsed time to millions of operations per second.
+static inline double bench_mops(size_t ops, uint64_t ns)
+{
+    return ns ? (double) ops * 1e3 / (double) ns : 0.0;
+}
+
+#endif // STACK_BENCH_H
@@ -0,0 +1,72 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stack_alloc.h>
+#include <stack_dyn.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define REQUESTS    100000
+#define DEPTH       600
+#define ARENA_BLOCK (64 * 1024)
+
+// Runs request-scoped stacks: create, fill, drain half, destroy.
+static void bench_requests(const char *label, const StackAllocator *allocator, StackArena *arena)
+{
+    size_t checksum = 0;
+
+    uint64_t start = bench_now_ns();
+    for (size_t r = 0; r < REQUESTS; ++r)
+    {
+        StackDyn *dyn = NULL;
+        StackPool *pool = NULL;
+        void *data = NULL;
+        size_t value = 0;
+
+        if (stack_dyn_init_allocator(&dyn, NULL, NULL, false, allocator) != STACK_OK ||
+            stack_pool_init_allocator(&pool, 64, sizeof(size_t), STACK_POOL_SEGMENTED, 0,
+                                      allocator) != STACK_OK)
+        {
+            fprintf(stderr, "Stack initialization failed!\n");
+            exit(EXIT_FAILURE);
+        }
+
+        for (size_t i = 0; i < DEPTH; ++i)
+        {
+            stack_dyn_push(dyn, (void *) i);
+            stack_pool_push(pool, &i);
+        }
+        for (size_t i = 0; i < DEPTH / 2; ++i)
+        {
+            stack_dyn_pop(dyn, &data);
+            stack_pool_pop(pool, &value);
+            checksum += (size_t) data + value;
+        }
+
+        stack_dyn_destroy(dyn);
+        stack_pool_destroy(pool);
+        if (arena)
+            stack_arena_reset(arena);
+    }
+    uint64_t ns = bench_now_ns() - start;
+
+    printf("%-8s %8.0f ns/request  (checksum %zu)\n", label, (double) ns / REQUESTS, checksum);
+}
+
+int main(void)
+{
+    StackArena arena;
+    StackAllocator allocator;
+
+    if (stack_arena_init(&arena, ARENA_BLOCK) != STACK_OK ||
+        stack_arena_allocator(&arena, &allocator) != STACK_OK)
+        return EXIT_FAILURE;
+
+    printf("=== Request-scoped StackDyn + StackPool, %d elements each ===\n", DEPTH);
+    bench_requests("malloc", &stack_allocator_malloc, NULL);
+    bench_requests("arena", &allocator, &arena);
+
+    stack_arena_destroy(&arena);
+    return 0;
+}
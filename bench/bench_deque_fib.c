@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <stack_deque.h>
+#include "bench.h"
+
+#define FIB_N       34
+#define FIB_CUTOFF  16
+#define MAX_THREADS 8
+
+// Tasks are split into fib(n - 1) and fib(n - 2) until n drops below
+// the cutoff, the leaves are summed into the result.
+typedef struct {
+    StackDeque *deques[MAX_THREADS];
+    int thread_count;
+    atomic_long pending;
+    atomic_ullong result;
+} FibPool;
+
+typedef struct {
+    FibPool *pool;
+    int id;
+    unsigned seed;
+} FibWorker;
+
+static unsigned long long fib_seq(int n)
+{
+    return n < 2 ? (unsigned long long) n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+static unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 16;
+}
+
+static void run_task(FibPool *pool, StackDeque *own, int n)
+{
+    if (n < FIB_CUTOFF)
+    {
+        atomic_fetch_add_explicit(&pool->result, fib_seq(n), memory_order_relaxed);
+    }
+    else
+    {
+        int left = n - 1;
+        int right = n - 2;
+
+        atomic_fetch_add_explicit(&pool->pending, 2, memory_order_relaxed);
+        stack_deque_push(own, &left);
+        stack_deque_push(own, &right);
+    }
+    atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+}
+
+static void *fib_worker(void *arg)
+{
+    FibWorker *worker = arg;
+    FibPool *pool = worker->pool;
+    StackDeque *own = pool->deques[worker->id];
+    int n = 0;
+
+    while (atomic_load_explicit(&pool->pending, memory_order_acquire) > 0)
+    {
+        if (stack_deque_pop(own, &n) == STACK_OK)
+        {
+            run_task(pool, own, n);
+            continue;
+        }
+
+        if (pool->thread_count == 1)
+            continue;
+
+        int victim = (int) (next_random(&worker->seed) % (unsigned) pool->thread_count);
+        if (victim != worker->id && stack_deque_steal(pool->deques[victim], &n) == STACK_OK)
+            run_task(pool, own, n);
+    }
+    return NULL;
+}
+
+static double run_parallel(int thread_count, unsigned long long *out_result)
+{
+    FibPool pool;
+    FibWorker workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    int n = FIB_N;
+
+    pool.thread_count = thread_count;
+    atomic_init(&pool.pending, 1);
+    atomic_init(&pool.result, 0);
+    for (int t = 0; t < thread_count; ++t)
+    {
+        if (stack_deque_init(&pool.deques[t], 64, sizeof(int)) != STACK_OK)
+        {
+            fprintf(stderr, "Deque initialization failed!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    stack_deque_push(pool.deques[0], &n);
+
+    uint64_t start = bench_now_ns();
+    for (int t = 0; t < thread_count; ++t)
+    {
+        workers[t].pool = &pool;
+        workers[t].id = t;
+        workers[t].seed = (unsigned) t * 7919u + 1u;
+        pthread_create(&threads[t], NULL, fib_worker, &workers[t]);
+    }
+    for (int t = 0; t < thread_count; ++t)
+        pthread_join(threads[t], NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    for (int t = 0; t < thread_count; ++t)
+        stack_deque_destroy(pool.deques[t]);
+
+    *out_result = atomic_load(&pool.result);
+    return (double) elapsed / 1e6;
+}
+
+int main(void)
+{
+    unsigned long long expected = 0;
+    unsigned long long result = 0;
+
+    uint64_t start = bench_now_ns();
+    expected = fib_seq(FIB_N);
+    double sequential_ms = (double) (bench_now_ns() - start) / 1e6;
+
+    printf("=== Parallel fib(%d) on work-stealing deques, cutoff %d ===\n", FIB_N, FIB_CUTOFF);
+    printf("sequential: %.2f ms\n", sequential_ms);
+    printf("threads  time ms  speedup\n");
+
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        double parallel_ms = run_parallel(thread_count, &result);
+        if (result != expected)
+        {
+            fprintf(stderr, "Wrong result: %llu, expected %llu\n", result, expected);
+            return EXIT_FAILURE;
+        }
+        printf("%7d  %7.2f  %7.2f\n", thread_count, parallel_ms,
+               parallel_ms > 0.0 ? sequential_ms / parallel_ms : 0.0);
+    }
+
+    return 0;
+}
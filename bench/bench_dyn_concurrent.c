@@ -0,0 +1,114 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stack_dyn.h>
+#include <stack_dyn_concurrent.h>
+#include "bench.h"
+
+#define OPS_PER_THREAD 500000
+#define PREFILL        1024
+#define MAX_THREADS    16
+
+// StackDyn guarded by a mutex, the setup the lock-free stack replaces.
+typedef struct {
+    pthread_mutex_t lock;
+    StackDyn *stack;
+} LockedStack;
+
+typedef struct {
+    LockedStack *locked;
+    StackDynConcurrent *concurrent;
+    size_t checksum;
+} WorkerArgs;
+
+static void *locked_worker(void *arg)
+{
+    WorkerArgs *args = arg;
+    void *data = NULL;
+
+    for (size_t i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        pthread_mutex_lock(&args->locked->lock);
+        stack_dyn_push(args->locked->stack, (void *) i);
+        pthread_mutex_unlock(&args->locked->lock);
+
+        pthread_mutex_lock(&args->locked->lock);
+        if (stack_dyn_pop(args->locked->stack, &data) == STACK_OK)
+            args->checksum += (size_t) data;
+        pthread_mutex_unlock(&args->locked->lock);
+    }
+    return NULL;
+}
+
+static void *concurrent_worker(void *arg)
+{
+    WorkerArgs *args = arg;
+    void *data = NULL;
+
+    for (size_t i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        stack_dyn_concurrent_push(args->concurrent, (void *) i);
+        if (stack_dyn_concurrent_pop(args->concurrent, &data) == STACK_OK)
+            args->checksum += (size_t) data;
+    }
+    return NULL;
+}
+
+static double run_threads(int thread_count, void *(*worker)(void *),
+                          LockedStack *locked, StackDynConcurrent *concurrent)
+{
+    pthread_t threads[MAX_THREADS];
+    WorkerArgs args[MAX_THREADS];
+
+    uint64_t start = bench_now_ns();
+    for (int t = 0; t < thread_count; ++t)
+    {
+        args[t].locked = locked;
+        args[t].concurrent = concurrent;
+        args[t].checksum = 0;
+        pthread_create(&threads[t], NULL, worker, &args[t]);
+    }
+    for (int t = 0; t < thread_count; ++t)
+        pthread_join(threads[t], NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    return bench_mops((size_t) thread_count * OPS_PER_THREAD * 2, elapsed);
+}
+
+int main(void)
+{
+    printf("=== Lock-free vs mutex-wrapped StackDyn, push/pop pairs ===\n");
+    printf("threads  mutex Mops/s  lock-free Mops/s\n");
+
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        LockedStack locked;
+        StackDynConcurrent *concurrent = NULL;
+
+        pthread_mutex_init(&locked.lock, NULL);
+        if (stack_dyn_init(&locked.stack, NULL, NULL) != STACK_OK ||
+            stack_dyn_concurrent_init(&concurrent, NULL, NULL) != STACK_OK)
+        {
+            fprintf(stderr, "Stack initialization failed!\n");
+            return EXIT_FAILURE;
+        }
+
+        for (size_t i = 0; i < PREFILL; ++i)
+        {
+            stack_dyn_push(locked.stack, (void *) i);
+            stack_dyn_concurrent_push(concurrent, (void *) i);
+        }
+
+        double mutex_mops = run_threads(thread_count, locked_worker, &locked, NULL);
+        double lock_free_mops = run_threads(thread_count, concurrent_worker, NULL, concurrent);
+        printf("%7d  %12.2f  %16.2f\n", thread_count, mutex_mops, lock_free_mops);
+
+        stack_dyn_destroy(locked.stack);
+        stack_dyn_concurrent_destroy(concurrent);
+        pthread_mutex_destroy(&locked.lock);
+    }
+
+    return 0;
+}
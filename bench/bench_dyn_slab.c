@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stack_dyn.h>
+#include "bench.h"
+
+#define FILL_COUNT  1000000
+#define CHURN_DEPTH 1000
+#define CHURN_OPS   10000000
+
+// Reference list reproducing the former calloc/free per node behaviour.
+typedef struct {
+    StNode *top;
+    size_t size;
+} RefStack;
+
+static int ref_push(RefStack *stack, void *data)
+{
+    StNode *node = calloc(1, sizeof(StNode));
+    if (!node)
+        return -1;
+
+    node->data = data;
+    node->next = stack->top;
+    stack->top = node;
+    ++stack->size;
+    return 0;
+}
+
+static void *ref_pop(RefStack *stack)
+{
+    StNode *node = stack->top;
+    void *data = node->data;
+    stack->top = node->next;
+    --stack->size;
+    free(node);
+    return data;
+}
+
+static void bench_reference(void)
+{
+    RefStack stack = {NULL, 0};
+    size_t checksum = 0;
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < FILL_COUNT; ++i)
+        ref_push(&stack, (void *) i);
+    while (stack.size)
+        checksum += (size_t) ref_pop(&stack);
+    uint64_t fill_ns = bench_now_ns() - start;
+
+    for (size_t i = 0; i < CHURN_DEPTH; ++i)
+        ref_push(&stack, (void *) i);
+    start = bench_now_ns();
+    for (size_t i = 0; i < CHURN_OPS; ++i)
+    {
+        ref_push(&stack, (void *) i);
+        checksum += (size_t) ref_pop(&stack);
+    }
+    uint64_t churn_ns = bench_now_ns() - start;
+    while (stack.size)
+        ref_pop(&stack);
+
+    printf("calloc-per-node  fill/drain %8.2f Mops/s  churn %8.2f Mops/s  (checksum %zu)\n",
+           bench_mops(2 * FILL_COUNT, fill_ns), bench_mops(2 * CHURN_OPS, churn_ns), checksum);
+}
+
+typedef StackError (*stack_dyn_init_fn)(StackDyn **, stack_copy_data, stack_destroy_data);
+
+static void bench_stack_dyn(const char *label, stack_dyn_init_fn init)
+{
+    StackDyn *stack = NULL;
+    void *data = NULL;
+    size_t checksum = 0;
+
+    if (init(&stack, NULL, NULL) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < FILL_COUNT; ++i)
+        stack_dyn_push(stack, (void *) i);
+    while (stack_dyn_pop(stack, &data) == STACK_OK)
+        checksum += (size_t) data;
+    uint64_t fill_ns = bench_now_ns() - start;
+
+    for (size_t i = 0; i < CHURN_DEPTH; ++i)
+        stack_dyn_push(stack, (void *) i);
+    start = bench_now_ns();
+    for (size_t i = 0; i < CHURN_OPS; ++i)
+    {
+        stack_dyn_push(stack, (void *) i);
+        stack_dyn_pop(stack, &data);
+        checksum += (size_t) data;
+    }
+    uint64_t churn_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    stack_dyn_destroy(stack);
+    uint64_t destroy_ns = bench_now_ns() - start;
+
+    printf("%-16s fill/drain %8.2f Mops/s  churn %8.2f Mops/s  (checksum %zu)\n",
+           label, bench_mops(2 * FILL_COUNT, fill_ns), bench_mops(2 * CHURN_OPS, churn_ns), checksum);
+    printf("%-16s destroy of %d elements after a peak of %d: %llu ns\n",
+           label, CHURN_DEPTH, FILL_COUNT, (unsigned long long) destroy_ns);
+}
+
+int main(void)
+{
+    printf("=== StackDyn push/pop throughput ===\n");
+    bench_reference();
+    bench_stack_dyn("stack_dyn slabs", stack_dyn_init);
+    bench_stack_dyn("stack_dyn chunks", stack_dyn_init_chunked);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stack_dyn_concurrent.h>
+#include "bench.h"
+
+#define OPS_PER_THREAD    500000
+#define PREFILL           1024
+#define MAX_THREADS       64
+#define ELIMINATION_SLOTS 16
+
+typedef struct {
+    StackDynConcurrent *stack;
+    unsigned push_percent;
+    unsigned seed;
+} WorkerArgs;
+
+static void *mixed_worker(void *arg)
+{
+    WorkerArgs *args = arg;
+    unsigned seed = args->seed;
+    void *data = NULL;
+
+    for (size_t i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        if ((seed >> 16) % 100 < args->push_percent)
+            stack_dyn_concurrent_push(args->stack, (void *) i);
+        else
+            stack_dyn_concurrent_pop(args->stack, &data);
+    }
+    return NULL;
+}
+
+static double run_threads(int thread_count, unsigned push_percent, size_t slots)
+{
+    StackDynConcurrent *stack = NULL;
+    pthread_t threads[MAX_THREADS];
+    WorkerArgs args[MAX_THREADS];
+    StackError err = slots ? stack_dyn_concurrent_init_elimination(&stack, NULL, NULL, slots)
+                           : stack_dyn_concurrent_init(&stack, NULL, NULL);
+
+    if (err != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < PREFILL; ++i)
+        stack_dyn_concurrent_push(stack, (void *) i);
+
+    uint64_t start = bench_now_ns();
+    for (int t = 0; t < thread_count; ++t)
+    {
+        args[t].stack = stack;
+        args[t].push_percent = push_percent;
+        args[t].seed = (unsigned) t * 7919u + 1u;
+        pthread_create(&threads[t], NULL, mixed_worker, &args[t]);
+    }
+    for (int t = 0; t < thread_count; ++t)
+        pthread_join(threads[t], NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    stack_dyn_concurrent_destroy(stack);
+    return bench_mops((size_t) thread_count * OPS_PER_THREAD, elapsed);
+}
+
+// Usage: bench_elimination [max_threads] [push_percent]
+int main(int argc, char **argv)
+{
+    int max_threads = argc > 1 ? atoi(argv[1]) : 16;
+    int push_percent = argc > 2 ? atoi(argv[2]) : 50;
+
+    if (max_threads < 1 || max_threads > MAX_THREADS || push_percent < 0 || push_percent > 100)
+    {
+        fprintf(stderr, "Usage: %s [max_threads 1..%d] [push_percent 0..100]\n",
+                argv[0], MAX_THREADS);
+        return EXIT_FAILURE;
+    }
+
+    printf("=== Treiber stack with and without elimination, %d%% pushes ===\n", push_percent);
+    printf("threads  plain Mops/s  elimination Mops/s\n");
+
+    for (int thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+    {
+        double plain_mops = run_threads(thread_count, (unsigned) push_percent, 0);
+        double elimination_mops = run_threads(thread_count, (unsigned) push_percent,
+                                              ELIMINATION_SLOTS);
+        printf("%7d  %12.2f  %18.2f\n", thread_count, plain_mops, elimination_mops);
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <sys/epoll.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define STACKS        4096
+#define ROUNDS        200
+#define ACTIVE        32
+#define BURST         64
+#define MAX_EVENTS    64
+
+static StackPool *stacks[STACKS];
+
+// Pushes a burst into ACTIVE random stacks.
+static void produce(unsigned *seed)
+{
+    for (int a = 0; a < ACTIVE; ++a)
+    {
+        *seed = *seed * 1103515245u + 12345u;
+        StackPool *stack = stacks[(*seed >> 8) % STACKS];
+        for (int i = 0; i < BURST; ++i)
+            stack_pool_push(stack, &i);
+    }
+}
+
+static size_t drain(StackPool *stack)
+{
+    int value = 0;
+    size_t popped = 0;
+
+    while (stack_pool_pop(stack, &value) == STACK_OK)
+        ++popped;
+    return popped;
+}
+
+int main(void)
+{
+    struct epoll_event events[MAX_EVENTS];
+    int epoll_fd = epoll_create1(0);
+    unsigned seed = 1;
+    size_t popped = 0;
+    size_t wakeups = 0;
+
+    if (epoll_fd < 0)
+    {
+        perror("epoll_create1");
+        return EXIT_FAILURE;
+    }
+
+    for (int s = 0; s < STACKS; ++s)
+    {
+        if (stack_pool_init(&stacks[s], BURST * ACTIVE, sizeof(int)) != STACK_OK)
+        {
+            fprintf(stderr, "Stack initialization failed!\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("=== %d stacks, %d bursts of %d pushes per round ===\n", STACKS, ACTIVE, BURST);
+    printf("consumer         ms  pushes/wakeup\n");
+
+    // Scanning every stack for work
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        produce(&seed);
+        for (int s = 0; s < STACKS; ++s)
+        {
+            bool empty = true;
+            stack_pool_is_empty(stacks[s], &empty);
+            if (!empty)
+                popped += drain(stacks[s]);
+        }
+    }
+    double scan_ms = (double) (bench_now_ns() - start) / 1e6;
+    printf("is_empty scan  %6.2f  %13s\n", scan_ms, "-");
+
+    // Waiting on the readiness descriptors
+    for (int s = 0; s < STACKS; ++s)
+    {
+        int fd = -1;
+        struct epoll_event event = {.events = EPOLLIN | EPOLLET, .data.u32 = (uint32_t) s};
+
+        if (stack_pool_event_open(stacks[s], 0, &fd) != STACK_OK ||
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            fprintf(stderr, "Readiness descriptor setup failed!\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    start = bench_now_ns();
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        produce(&seed);
+        int ready = 0;
+        while ((ready = epoll_wait(epoll_fd, events, MAX_EVENTS, 0)) > 0)
+        {
+            for (int e = 0; e < ready; ++e)
+            {
+                StackPool *stack = stacks[events[e].data.u32];
+                stack_pool_event_ack(stack);
+                popped += drain(stack);
+                ++wakeups;
+            }
+        }
+    }
+    double epoll_ms = (double) (bench_now_ns() - start) / 1e6;
+    printf("epoll          %6.2f  %13.1f\n", epoll_ms,
+           wakeups ? (double) ROUNDS * ACTIVE * BURST / (double) wakeups : 0.0);
+
+    if (popped != (size_t) 2 * ROUNDS * ACTIVE * BURST)
+    {
+        fprintf(stderr, "Lost elements: %zu\n", popped);
+        return EXIT_FAILURE;
+    }
+
+    for (int s = 0; s < STACKS; ++s)
+        stack_pool_destroy(stacks[s]);
+    return 0;
+}
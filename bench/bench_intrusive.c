@@ -0,0 +1,87 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stack_dyn.h>
+#include <stack_intrusive.h>
+#include "bench.h"
+
+#define POOL_OBJECTS 65536
+#define CHURN_OPS    10000000
+
+// Pooled object threaded onto a free list
+typedef struct {
+    size_t id;
+    StackLink link;
+    char payload[48];
+} PoolObject;
+
+static PoolObject objects[POOL_OBJECTS];
+
+static void bench_dyn(void)
+{
+    StackDyn *stack = NULL;
+    void *data = NULL;
+    size_t checksum = 0;
+
+    if (stack_dyn_init(&stack, NULL, NULL) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < POOL_OBJECTS; ++i)
+        stack_dyn_push(stack, &objects[i]);
+    uint64_t fill_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < CHURN_OPS; ++i)
+    {
+        stack_dyn_pop(stack, &data);
+        checksum += ((PoolObject *) data)->id;
+        stack_dyn_push(stack, data);
+    }
+    uint64_t churn_ns = bench_now_ns() - start;
+    stack_dyn_destroy(stack);
+
+    printf("stack_dyn        fill %8.2f Mops/s  churn %8.2f Mops/s  (checksum %zu)\n",
+           bench_mops(POOL_OBJECTS, fill_ns), bench_mops(2 * CHURN_OPS, churn_ns), checksum);
+}
+
+static void bench_intrusive(void)
+{
+    StackIntrusive stack;
+    StackLink *link = NULL;
+    size_t checksum = 0;
+
+    stack_intrusive_init(&stack);
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < POOL_OBJECTS; ++i)
+        stack_intrusive_push(&stack, &objects[i].link);
+    uint64_t fill_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < CHURN_OPS; ++i)
+    {
+        stack_intrusive_pop(&stack, &link);
+        checksum += STACK_CONTAINER_OF(link, PoolObject, link)->id;
+        stack_intrusive_push(&stack, link);
+    }
+    uint64_t churn_ns = bench_now_ns() - start;
+
+    printf("stack_intrusive  fill %8.2f Mops/s  churn %8.2f Mops/s  (checksum %zu)\n",
+           bench_mops(POOL_OBJECTS, fill_ns), bench_mops(2 * CHURN_OPS, churn_ns), checksum);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < POOL_OBJECTS; ++i)
+        objects[i].id = i;
+
+    printf("=== Free list of %d pooled objects ===\n", POOL_OBJECTS);
+    bench_dyn();
+    bench_intrusive();
+    return 0;
+}
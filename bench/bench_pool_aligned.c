@@ -0,0 +1,75 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define DEFAULT_DEPTH (4u << 20)
+#define ROUNDS        3
+
+typedef struct {
+    const char *name;
+    size_t align;
+    StackPoolPages pages;
+} Layout;
+
+static const Layout layouts[] = {
+    {"packed", 0, STACK_POOL_PAGES_DEFAULT},
+    {"align 64", 64, STACK_POOL_PAGES_DEFAULT},
+    {"align 64 + THP", 64, STACK_POOL_PAGES_TRANSPARENT},
+    {"align 64 + hugetlb", 64, STACK_POOL_PAGES_HUGETLB},
+};
+
+// Fills the stack to depth and drains it ROUNDS times, prints the rates.
+static void run(const Layout *layout, size_t block_size, size_t depth)
+{
+    StackPool *stack = NULL;
+    unsigned char block[128];
+
+    if (stack_pool_init_aligned(&stack, depth, block_size, layout->align,
+                                layout->pages) != STACK_OK)
+    {
+        printf("%-20s %4zu B  unavailable\n", layout->name, block_size);
+        return;
+    }
+
+    memset(block, 0x5a, sizeof(block));
+    uint64_t push_ns = 0;
+    uint64_t pop_ns = 0;
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        uint64_t start = bench_now_ns();
+        for (size_t i = 0; i < depth; ++i)
+            stack_pool_push(stack, block);
+        push_ns += bench_now_ns() - start;
+
+        start = bench_now_ns();
+        for (size_t i = 0; i < depth; ++i)
+            stack_pool_pop(stack, block);
+        pop_ns += bench_now_ns() - start;
+    }
+
+    printf("%-20s %4zu B  stride %4zu  push %8.2f Mops/s  pop %8.2f Mops/s  pool %6zu MB\n",
+           layout->name, block_size, stack->stride, bench_mops(depth * ROUNDS, push_ns),
+           bench_mops(depth * ROUNDS, pop_ns), depth * stack->stride >> 20);
+    stack_pool_destroy(stack);
+}
+
+// Usage: bench_pool_aligned [depth]
+int main(int argc, char **argv)
+{
+    size_t depth = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_DEPTH;
+    const size_t sizes[] = {24, 48, 96};
+
+    printf("=== Push/pop of %zu blocks, %d rounds ===\n", depth, ROUNDS);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        for (size_t l = 0; l < sizeof(layouts) / sizeof(layouts[0]); ++l)
+            run(&layouts[l], sizes[s], depth);
+    }
+
+    return 0;
+}
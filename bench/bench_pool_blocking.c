@@ -0,0 +1,129 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include <stack_pool_blocking.h>
+#include "bench.h"
+
+#define ITEMS       20000
+#define INTERVAL_NS 20000
+#define POLL_NS     50000
+#define CAPACITY    64
+
+// How the consumer waits for an element
+typedef enum {
+    WAIT_SPIN,      // Retry the non-blocking pop, yielding in between
+    WAIT_SLEEP,     // Retry the non-blocking pop after a short sleep
+    WAIT_BLOCK,     // pop_wait without a timeout
+} WaitMode;
+
+typedef struct {
+    StackPoolBlocking *stack;
+    WaitMode mode;
+    uint64_t *latencies;
+    uint64_t cpu_ns;
+} ConsumerArgs;
+
+static uint64_t thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+static void *consumer(void *arg)
+{
+    ConsumerArgs *args = arg;
+    struct timespec poll = {0, POLL_NS};
+    uint64_t sent = 0;
+    uint64_t cpu_start = thread_cpu_ns();
+
+    for (size_t i = 0; i < ITEMS; ++i)
+    {
+        if (args->mode == WAIT_BLOCK)
+            stack_pool_blocking_pop_wait(args->stack, &sent, STACK_WAIT_FOREVER);
+        else
+        {
+            while (stack_pool_blocking_pop(args->stack, &sent) != STACK_OK)
+            {
+                if (args->mode == WAIT_SPIN)
+                    sched_yield();
+                else
+                    nanosleep(&poll, NULL);
+            }
+        }
+        args->latencies[i] = bench_now_ns() - sent;
+    }
+
+    args->cpu_ns = thread_cpu_ns() - cpu_start;
+    return NULL;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static void run(const char *name, WaitMode mode)
+{
+    StackPoolBlocking *stack = NULL;
+    pthread_t thread;
+    ConsumerArgs args;
+    struct timespec interval = {0, INTERVAL_NS};
+
+    if (stack_pool_blocking_init(&stack, CAPACITY, sizeof(uint64_t)) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    args.stack = stack;
+    args.mode = mode;
+    args.latencies = malloc(ITEMS * sizeof(uint64_t));
+    if (!args.latencies)
+    {
+        fprintf(stderr, "Allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t start = bench_now_ns();
+    pthread_create(&thread, NULL, consumer, &args);
+
+    // The producer hands over a timestamp at a steady rate
+    for (size_t i = 0; i < ITEMS; ++i)
+    {
+        uint64_t sent = bench_now_ns();
+        stack_pool_blocking_push_wait(stack, &sent, STACK_WAIT_FOREVER);
+        nanosleep(&interval, NULL);
+    }
+    pthread_join(thread, NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    qsort(args.latencies, ITEMS, sizeof(uint64_t), compare_u64);
+    printf("%-10s  %8.1f  %8.1f  %8.1f  %6.1f\n", name,
+           (double) args.latencies[ITEMS / 2] / 1e3,
+           (double) args.latencies[ITEMS * 99 / 100] / 1e3,
+           (double) args.latencies[ITEMS - 1] / 1e3,
+           100.0 * (double) args.cpu_ns / (double) elapsed);
+
+    free(args.latencies);
+    stack_pool_blocking_destroy(stack);
+}
+
+int main(void)
+{
+    printf("=== Consumer waiting: poll loops vs pop_wait, one item every %d us ===\n",
+           INTERVAL_NS / 1000);
+    printf("mode        p50 us    p99 us    max us   CPU %%\n");
+
+    run("spin-poll", WAIT_SPIN);
+    run("sleep-poll", WAIT_SLEEP);
+    run("pop_wait", WAIT_BLOCK);
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stack_pool.h>
+#include <stack_pool_combining.h>
+#include "bench.h"
+
+#define OPS_PER_THREAD 200000
+#define CAPACITY       4096
+#define PREFILL        1024
+#define MAX_THREADS    16
+
+typedef struct {
+    unsigned char bytes[16];
+} Block;
+
+// StackPool guarded by a mutex, the setup the combining stack replaces.
+typedef struct {
+    pthread_mutex_t lock;
+    StackPool *stack;
+} LockedPool;
+
+typedef struct {
+    LockedPool *locked;
+    StackPoolCombining *combining;
+} WorkerArgs;
+
+static void *locked_worker(void *arg)
+{
+    WorkerArgs *args = arg;
+    Block block = {{0}};
+
+    for (size_t i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        pthread_mutex_lock(&args->locked->lock);
+        stack_pool_push(args->locked->stack, &block);
+        pthread_mutex_unlock(&args->locked->lock);
+
+        pthread_mutex_lock(&args->locked->lock);
+        stack_pool_pop(args->locked->stack, &block);
+        pthread_mutex_unlock(&args->locked->lock);
+    }
+    return NULL;
+}
+
+static void *combining_worker(void *arg)
+{
+    WorkerArgs *args = arg;
+    Block block = {{0}};
+
+    for (size_t i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        stack_pool_combining_push(args->combining, &block);
+        stack_pool_combining_pop(args->combining, &block);
+    }
+    return NULL;
+}
+
+static double run_threads(int thread_count, void *(*worker)(void *),
+                          LockedPool *locked, StackPoolCombining *combining)
+{
+    pthread_t threads[MAX_THREADS];
+    WorkerArgs args = {locked, combining};
+
+    uint64_t start = bench_now_ns();
+    for (int t = 0; t < thread_count; ++t)
+        pthread_create(&threads[t], NULL, worker, &args);
+    for (int t = 0; t < thread_count; ++t)
+        pthread_join(threads[t], NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    return bench_mops((size_t) thread_count * OPS_PER_THREAD * 2, elapsed);
+}
+
+int main(void)
+{
+    Block block = {{0}};
+
+    printf("=== Flat combining vs mutex-wrapped StackPool, %zu-byte blocks ===\n", sizeof(Block));
+    printf("threads  mutex Mops/s  combining Mops/s\n");
+
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        LockedPool locked;
+        StackPoolCombining *combining = NULL;
+
+        pthread_mutex_init(&locked.lock, NULL);
+        if (stack_pool_init(&locked.stack, CAPACITY, sizeof(Block)) != STACK_OK ||
+            stack_pool_combining_init(&combining, CAPACITY, sizeof(Block)) != STACK_OK)
+        {
+            fprintf(stderr, "Stack initialization failed!\n");
+            return EXIT_FAILURE;
+        }
+
+        for (size_t i = 0; i < PREFILL; ++i)
+        {
+            stack_pool_push(locked.stack, &block);
+            stack_pool_combining_push(combining, &block);
+        }
+
+        double mutex_mops = run_threads(thread_count, locked_worker, &locked, NULL);
+        double combining_mops = run_threads(thread_count, combining_worker, NULL, combining);
+        printf("%7d  %12.2f  %16.2f\n", thread_count, mutex_mops, combining_mops);
+
+        stack_pool_destroy(locked.stack);
+        stack_pool_combining_destroy(combining);
+        pthread_mutex_destroy(&locked.lock);
+    }
+
+    return 0;
+}
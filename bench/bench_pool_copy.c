@@ -0,0 +1,93 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define DEPTH       1024
+#define TOTAL_BYTES (256u * 1024u * 1024u)
+#define MAX_BLOCK   512
+
+static unsigned char in[MAX_BLOCK];
+static unsigned char out[MAX_BLOCK];
+
+// Reference copy reproducing the former byte-by-byte loop.
+static void byte_loop_copy(void *dst, const void *src, size_t size)
+{
+    unsigned char *block = dst;
+    const unsigned char *data = src;
+    for (size_t i = 0; i < size; ++i)
+        *(block + i) = *(data + i);
+}
+
+static void bench_block_size(size_t block_size)
+{
+    StackPool *stack = NULL;
+    size_t rounds = TOTAL_BYTES / (block_size * DEPTH);
+    size_t checksum = 0;
+
+    if (rounds == 0)
+        rounds = 1;
+
+    if (stack_pool_init(&stack, DEPTH, block_size) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Push/pop through the selected kernel
+    uint64_t start = bench_now_ns();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        for (size_t i = 0; i < DEPTH; ++i)
+            stack_pool_push(stack, in);
+        while (stack_pool_pop(stack, out) == STACK_OK)
+            checksum += out[0];
+    }
+    uint64_t kernel_ns = bench_now_ns() - start;
+
+    // Same traffic through the byte loop, swapped in for comparison
+    stack_block_copy selected = stack->copy_block;
+    stack->copy_block = byte_loop_copy;
+    start = bench_now_ns();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        for (size_t i = 0; i < DEPTH; ++i)
+            stack_pool_push(stack, in);
+        while (stack_pool_pop(stack, out) == STACK_OK)
+            checksum += out[0];
+    }
+    uint64_t loop_ns = bench_now_ns() - start;
+    stack->copy_block = selected;
+
+    // Peek only
+    stack_pool_push(stack, in);
+    start = bench_now_ns();
+    for (size_t i = 0; i < rounds * DEPTH; ++i)
+    {
+        stack_pool_peek(stack, out);
+        checksum += out[0];
+    }
+    uint64_t peek_ns = bench_now_ns() - start;
+
+    double bytes = (double) (2 * rounds * DEPTH * block_size);
+    printf("%4zu B  kernel %8.2f GB/s  byte loop %8.2f GB/s  peek %6.2f ns/op  (checksum %zu)\n",
+           block_size, bytes / (double) kernel_ns, bytes / (double) loop_ns,
+           (double) peek_ns / (double) (rounds * DEPTH), checksum);
+
+    stack_pool_destroy(stack);
+}
+
+int main(void)
+{
+    size_t sizes[] = {1, 2, 4, 8, 16, 32, 64, 96, 128, 256, 512};
+
+    memset(in, 0x5A, sizeof(in));
+
+    printf("=== StackPool push/pop copy throughput ===\n");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        bench_block_size(sizes[i]);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define BLOCK_SIZE      64
+#define PUSH_COUNT      4000000
+#define INITIAL_CAPACITY 16
+
+typedef struct {
+    unsigned char payload[BLOCK_SIZE];
+} Block;
+
+static void bench_policy(const char *label, StackPoolGrowth growth, size_t capacity)
+{
+    StackPool *stack = NULL;
+    Block block;
+    uint64_t worst_ns = 0;
+    size_t checksum = 0;
+
+    memset(&block, 0, sizeof(block));
+
+    if (stack_pool_init_growable(&stack, capacity, BLOCK_SIZE, growth, PUSH_COUNT) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < PUSH_COUNT; ++i)
+    {
+        uint64_t op_start = (i & (i - 1)) == 0 ? bench_now_ns() : 0;
+
+        block.payload[0] = (unsigned char) i;
+        if (stack_pool_push(stack, &block) != STACK_OK)
+        {
+            fprintf(stderr, "Push failed at %zu\n", i);
+            exit(EXIT_FAILURE);
+        }
+
+        // Sample single pushes at powers of two, where growth happens
+        if (op_start)
+        {
+            uint64_t op_ns = bench_now_ns() - op_start;
+            if (op_ns > worst_ns)
+                worst_ns = op_ns;
+        }
+    }
+    uint64_t push_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    while (stack_pool_pop(stack, &block) == STACK_OK)
+        checksum += block.payload[0];
+    uint64_t pop_ns = bench_now_ns() - start;
+
+    printf("%-22s push %6.2f ns/op  pop %6.2f ns/op  worst growth push %8llu ns  (checksum %zu)\n",
+           label, (double) push_ns / PUSH_COUNT, (double) pop_ns / PUSH_COUNT,
+           (unsigned long long) worst_ns, checksum);
+
+    stack_pool_destroy(stack);
+}
+
+int main(void)
+{
+    printf("=== StackPool growth, %d pushes of %d-byte blocks ===\n", PUSH_COUNT, BLOCK_SIZE);
+    bench_policy("fixed (preallocated)", STACK_POOL_FIXED, PUSH_COUNT);
+    bench_policy("double", STACK_POOL_DOUBLE, INITIAL_CAPACITY);
+    bench_policy("segmented", STACK_POOL_SEGMENTED, INITIAL_CAPACITY);
+    return 0;
+}
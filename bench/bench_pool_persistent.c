@@ -0,0 +1,78 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define DEFAULT_BLOCKS 1000000
+#define BLOCK_SIZE     64
+
+typedef struct {
+    unsigned char bytes[BLOCK_SIZE];
+} Block;
+
+static double elapsed_ms(uint64_t start)
+{
+    return (double) (bench_now_ns() - start) / 1e6;
+}
+
+// Usage: bench_pool_persistent [blocks] [path]
+int main(int argc, char **argv)
+{
+    size_t blocks = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_BLOCKS;
+    const char *path = argc > 2 ? argv[2] : "/tmp/bench_pool_persistent.bin";
+    StackPool *stack = NULL;
+    Block block;
+
+    memset(&block, 0xab, sizeof(block));
+    unlink(path);
+
+    printf("=== Restart of a %zu MB stack of %d-byte blocks ===\n",
+           blocks * BLOCK_SIZE >> 20, BLOCK_SIZE);
+
+    // Rebuilding in memory, what a restart costs without persistence
+    uint64_t start = bench_now_ns();
+    if (stack_pool_init(&stack, blocks, sizeof(Block)) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < blocks; ++i)
+        stack_pool_push(stack, &block);
+    printf("rebuild in memory   %10.2f ms\n", elapsed_ms(start));
+    stack_pool_destroy(stack);
+
+    if (stack_pool_open(&stack, path, blocks, sizeof(Block)) != STACK_OK)
+    {
+        fprintf(stderr, "Stack file could not be created!\n");
+        return EXIT_FAILURE;
+    }
+    start = bench_now_ns();
+    for (size_t i = 0; i < blocks; ++i)
+        stack_pool_push(stack, &block);
+    printf("fill mapped file    %10.2f ms\n", elapsed_ms(start));
+
+    start = bench_now_ns();
+    stack_pool_sync(stack);
+    printf("stack_pool_sync     %10.2f ms\n", elapsed_ms(start));
+    stack_pool_destroy(stack);
+
+    start = bench_now_ns();
+    if (stack_pool_open(&stack, path, 0, sizeof(Block)) != STACK_OK || stack->size != blocks)
+    {
+        fprintf(stderr, "Stack file could not be reopened!\n");
+        return EXIT_FAILURE;
+    }
+    printf("stack_pool_open     %10.2f ms\n", elapsed_ms(start));
+
+    start = bench_now_ns();
+    stack_pool_pop(stack, &block);
+    printf("first pop           %10.3f ms\n", elapsed_ms(start));
+
+    stack_pool_destroy(stack);
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define DEFAULT_CAPACITY (16u << 20)
+#define BLOCK_SIZE       64
+
+typedef struct {
+    unsigned char bytes[BLOCK_SIZE];
+} Block;
+
+// Returns the resident set size of the process in megabytes, -1 if unknown.
+static double rss_mb(void)
+{
+    long pages = -1;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return -1.0;
+    if (fscanf(statm, "%*s %ld", &pages) != 1)
+        pages = -1;
+    fclose(statm);
+    return pages < 0 ? -1.0 : (double) pages * (double) sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+// Fills the stack to depth, drains it and prints the init time and RSS at each stage.
+static void run(const char *name, StackPool *stack, uint64_t init_ns, size_t depth)
+{
+    Block block;
+    memset(&block, 0xab, sizeof(block));
+
+    double after_init = rss_mb();
+    for (size_t i = 0; i < depth; ++i)
+        stack_pool_push(stack, &block);
+    double after_fill = rss_mb();
+    while (stack_pool_pop(stack, &block) == STACK_OK)
+        ;
+    double after_drain = rss_mb();
+
+    printf("%-9s init %10.3f ms  RSS init %8.1f MB  filled %8.1f MB  drained %8.1f MB\n",
+           name, (double) init_ns / 1e6, after_init, after_fill, after_drain);
+}
+
+// Usage: bench_pool_reserved [capacity] [depth]
+int main(int argc, char **argv)
+{
+    size_t capacity = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_CAPACITY;
+    size_t depth = argc > 2 ? strtoull(argv[2], NULL, 10) : capacity / 16;
+    StackPool *stack = NULL;
+
+    printf("=== Pool of %zu MB, filled to %zu MB, RSS at start %.1f MB ===\n",
+           capacity * BLOCK_SIZE >> 20, depth * BLOCK_SIZE >> 20, rss_mb());
+
+    uint64_t start = bench_now_ns();
+    if (stack_pool_init(&stack, capacity, sizeof(Block)) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        return EXIT_FAILURE;
+    }
+    run("calloc", stack, bench_now_ns() - start, depth);
+    stack_pool_destroy(stack);
+
+    start = bench_now_ns();
+    if (stack_pool_init_reserved(&stack, capacity, sizeof(Block), 0) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        return EXIT_FAILURE;
+    }
+    run("reserved", stack, bench_now_ns() - start, depth);
+    stack_pool_destroy(stack);
+
+    return 0;
+}
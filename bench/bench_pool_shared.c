@@ -0,0 +1,65 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <stack_pool_shared.h>
+#include "bench.h"
+
+#define OPS_PER_PROCESS 500000
+#define CAPACITY        4096
+#define PREFILL         1024
+#define MAX_PROCESSES   8
+
+typedef struct {
+    unsigned char bytes[32];
+} Record;
+
+// Push/pop pairs from several forked processes on one shared stack.
+static double run_processes(int process_count)
+{
+    StackPoolShared *stack = NULL;
+    Record record = {{0}};
+    pid_t pids[MAX_PROCESSES];
+
+    if (stack_pool_shared_create(&stack, NULL, CAPACITY, sizeof(Record)) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < PREFILL; ++i)
+        stack_pool_shared_push(stack, &record);
+
+    uint64_t start = bench_now_ns();
+    for (int p = 0; p < process_count; ++p)
+    {
+        pids[p] = fork();
+        if (pids[p] == 0)
+        {
+            for (size_t i = 0; i < OPS_PER_PROCESS; ++i)
+            {
+                stack_pool_shared_push(stack, &record);
+                stack_pool_shared_pop(stack, &record);
+            }
+            _exit(0);
+        }
+    }
+    for (int p = 0; p < process_count; ++p)
+        waitpid(pids[p], NULL, 0);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    stack_pool_shared_detach(stack);
+    return bench_mops((size_t) process_count * OPS_PER_PROCESS * 2, elapsed);
+}
+
+int main(void)
+{
+    printf("=== Shared StackPool, push/pop pairs of %zu-byte records ===\n", sizeof(Record));
+    printf("processes  Mops/s\n");
+
+    for (int process_count = 1; process_count <= MAX_PROCESSES; process_count *= 2)
+        printf("%9d  %6.2f\n", process_count, run_processes(process_count));
+
+    return 0;
+}
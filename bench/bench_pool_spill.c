@@ -0,0 +1,96 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define DEFAULT_CAPACITY 65536
+#define DEFAULT_FACTOR   10
+#define BLOCK_SIZE       64
+
+typedef struct {
+    unsigned char bytes[BLOCK_SIZE];
+} Block;
+
+// Returns the peak resident set size of the process in megabytes.
+static double peak_rss_mb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (double) usage.ru_maxrss / 1024.0;
+}
+
+// Pushes and pops total blocks, checking the LIFO order, and prints the rates.
+static int run(const char *name, StackPool *stack, size_t total)
+{
+    Block block;
+    memset(&block, 0, sizeof(block));
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < total; ++i)
+    {
+        memcpy(block.bytes, &i, sizeof(i));
+        if (stack_pool_push(stack, &block) != STACK_OK)
+            return -1;
+    }
+    uint64_t push_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (size_t i = total; i-- > 0;)
+    {
+        size_t value = 0;
+        if (stack_pool_pop(stack, &block) != STACK_OK)
+            return -1;
+        memcpy(&value, block.bytes, sizeof(value));
+        if (value != i)
+            return -1;
+    }
+    uint64_t pop_ns = bench_now_ns() - start;
+
+    printf("%-10s push %8.2f Mops/s  pop %8.2f Mops/s  peak RSS %8.1f MB\n", name,
+           bench_mops(total, push_ns), bench_mops(total, pop_ns), peak_rss_mb());
+    return 0;
+}
+
+// Usage: bench_pool_spill [capacity] [factor] [dir]
+int main(int argc, char **argv)
+{
+    size_t capacity = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_CAPACITY;
+    size_t factor = argc > 2 ? strtoull(argv[2], NULL, 10) : DEFAULT_FACTOR;
+    const char *dir = argc > 3 ? argv[3] : NULL;
+    size_t total = capacity * factor;
+    StackPool *stack = NULL;
+
+    printf("=== %zu blocks of %d bytes (%zu MB), %zu in memory (%zu MB) ===\n", total,
+           BLOCK_SIZE, total * BLOCK_SIZE >> 20, capacity, capacity * BLOCK_SIZE >> 20);
+
+    // The spilling pool runs first, so the peak RSS it prints is its own
+    if (stack_pool_init_spill(&stack, capacity, sizeof(Block), dir) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        return EXIT_FAILURE;
+    }
+    if (run("spill", stack, total) != 0)
+    {
+        fprintf(stderr, "Spilling stack failed!\n");
+        return EXIT_FAILURE;
+    }
+    stack_pool_destroy(stack);
+
+    if (stack_pool_init(&stack, total, sizeof(Block)) != STACK_OK)
+    {
+        fprintf(stderr, "Stack initialization failed!\n");
+        return EXIT_FAILURE;
+    }
+    if (run("in memory", stack, total) != 0)
+    {
+        fprintf(stderr, "In-memory stack failed!\n");
+        return EXIT_FAILURE;
+    }
+    stack_pool_destroy(stack);
+
+    return 0;
+}
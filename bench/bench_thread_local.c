@@ -0,0 +1,80 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stack_pool.h>
+#include "bench.h"
+
+#define OPS_PER_THREAD 2000000
+#define MAX_THREADS    16
+
+// Shared error word written on every operation, as the former global was.
+static volatile StackError shared_last_error;
+
+typedef struct {
+    bool shared_store;
+    size_t checksum;
+} WorkerArgs;
+
+static void *worker(void *arg)
+{
+    WorkerArgs *args = arg;
+    StackPool *stack = NULL;
+    size_t value = 0;
+
+    if (stack_pool_init(&stack, 64, sizeof(size_t)) != STACK_OK)
+        return NULL;
+
+    for (size_t i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        StackError err = stack_pool_push(stack, &i);
+        if (args->shared_store)
+            shared_last_error = err;
+
+        err = stack_pool_pop(stack, &value);
+        if (args->shared_store)
+            shared_last_error = err;
+
+        args->checksum += value;
+    }
+
+    stack_pool_destroy(stack);
+    return NULL;
+}
+
+static double run_threads(int thread_count, bool shared_store)
+{
+    pthread_t threads[MAX_THREADS];
+    WorkerArgs args[MAX_THREADS];
+
+    uint64_t start = bench_now_ns();
+    for (int t = 0; t < thread_count; ++t)
+    {
+        args[t].shared_store = shared_store;
+        args[t].checksum = 0;
+        pthread_create(&threads[t], NULL, worker, &args[t]);
+    }
+    for (int t = 0; t < thread_count; ++t)
+        pthread_join(threads[t], NULL);
+
+    return bench_mops((size_t) thread_count * OPS_PER_THREAD * 2, bench_now_ns() - start);
+}
+
+int main(void)
+{
+    printf("=== One StackPool per thread, push/pop pairs ===\n");
+#ifdef STACK_NO_LAST_ERROR
+    printf("library built with STACK_NO_LAST_ERROR\n");
+#endif
+    printf("threads  thread-local Mops/s  + shared error store Mops/s\n");
+
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        double local_mops = run_threads(thread_count, false);
+        double shared_mops = run_threads(thread_count, true);
+        printf("%7d  %19.2f  %27.2f\n", thread_count, local_mops, shared_mops);
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stack_fast.h>
+#include "bench.h"
+
+#define DEPTH  256
+#define ROUNDS 40000
+
+static void bench_pool(void)
+{
+    StackPool *stack = NULL;
+    size_t value = 0;
+    size_t checksum = 0;
+
+    if (stack_pool_init(&stack, DEPTH, sizeof(size_t)) != STACK_OK)
+        exit(EXIT_FAILURE);
+
+    uint64_t start = bench_now_ns();
+    for (size_t r = 0; r < ROUNDS; ++r)
+    {
+        for (size_t i = 0; i < DEPTH; ++i)
+            stack_pool_push(stack, &i);
+        while (stack_pool_pop(stack, &value) == STACK_OK)
+            checksum += value;
+    }
+    uint64_t checked_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < ROUNDS; ++r)
+    {
+        for (size_t i = 0; i < DEPTH; ++i)
+            stack_pool_push_unchecked(stack, &i);
+        while (stack_pool_pop_unchecked(stack, &value) == STACK_OK)
+            checksum += value;
+    }
+    uint64_t unchecked_ns = bench_now_ns() - start;
+
+    double ops = 2.0 * ROUNDS * DEPTH;
+    printf("stack_pool  checked %6.2f ns/op  unchecked %6.2f ns/op  (checksum %zu)\n",
+           checked_ns / ops, unchecked_ns / ops, checksum);
+
+    stack_pool_destroy(stack);
+}
+
+static void bench_dyn(const char *label, StackError (*init)(StackDyn **, stack_copy_data, stack_destroy_data))
+{
+    StackDyn *stack = NULL;
+    void *data = NULL;
+    size_t checksum = 0;
+
+    if (init(&stack, NULL, NULL) != STACK_OK)
+        exit(EXIT_FAILURE);
+
+    uint64_t start = bench_now_ns();
+    for (size_t r = 0; r < ROUNDS; ++r)
+    {
+        for (size_t i = 0; i < DEPTH; ++i)
+            stack_dyn_push(stack, (void *) i);
+        while (stack_dyn_pop(stack, &data) == STACK_OK)
+            checksum += (size_t) data;
+    }
+    uint64_t checked_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < ROUNDS; ++r)
+    {
+        for (size_t i = 0; i < DEPTH; ++i)
+            stack_dyn_push_unchecked(stack, (void *) i);
+        while (stack_dyn_pop_unchecked(stack, &data) == STACK_OK)
+            checksum += (size_t) data;
+    }
+    uint64_t unchecked_ns = bench_now_ns() - start;
+
+    double ops = 2.0 * ROUNDS * DEPTH;
+    printf("%-11s checked %6.2f ns/op  unchecked %6.2f ns/op  (checksum %zu)\n",
+           label, checked_ns / ops, unchecked_ns / ops, checksum);
+
+    stack_dyn_destroy(stack);
+}
+
+int main(void)
+{
+    printf("=== Checked vs inline unchecked operations, push/pop at depth %d ===\n", DEPTH);
+    bench_pool();
+    bench_dyn("stack_dyn", stack_dyn_init);
+    bench_dyn("chunked", stack_dyn_init_chunked);
+    return 0;
+}
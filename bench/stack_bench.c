@@ -0,0 +1,683 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <stack_pool.h>
+#include <stack_dyn.h>
+#include <stack_trace.h>
+#include "bench.h"
+
+// Minimum number of operations timed by one repetition.
+#define MIN_OPS (1u << 20)
+
+// Maximum number of values in a -s or -d list.
+#define MAX_VALUES 16
+
+// Largest block size accepted by -s.
+#define MAX_BLOCK_SIZE 4096
+
+typedef enum {
+    FORMAT_TEXT = 0,
+    FORMAT_CSV,
+    FORMAT_JSON,
+} BenchFormat;
+
+// Operations of one backend. Every backend is driven through this table,
+// so all of them pay the same indirect call per operation.
+typedef struct {
+    const char *name;
+    bool sized;     // The block size changes what is copied
+    void *(*create)(size_t depth, size_t block_size);
+    int (*push)(void *stack, const void *data);
+    int (*pop)(void *stack, void *out);
+    int (*peek)(void *stack, void *out);
+    void (*clear)(void *stack);
+    void (*destroy)(void *stack);
+} BenchBackend;
+
+// Measurement of one operation mix.
+typedef struct {
+    const char *name;
+    // Runs the mix once, returns the elapsed time and the number of operations
+    uint64_t (*run)(const BenchBackend *backend, size_t depth, size_t block_size, size_t *out_ops);
+} BenchCase;
+
+// Summary of the repetitions of one case, in nanoseconds per operation.
+typedef struct {
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double max;
+} BenchStats;
+
+static size_t copy_size;
+static unsigned char source[MAX_BLOCK_SIZE];
+static unsigned char sink[MAX_BLOCK_SIZE];
+
+// ---- Backends ----
+
+static void *pool_create(size_t depth, size_t block_size)
+{
+    StackPool *stack = NULL;
+    return stack_pool_init(&stack, depth, block_size) == STACK_OK ? stack : NULL;
+}
+
+static int pool_push(void *stack, const void *data)
+{
+    return stack_pool_push(stack, data) == STACK_OK;
+}
+
+static int pool_pop(void *stack, void *out)
+{
+    return stack_pool_pop(stack, out) == STACK_OK;
+}
+
+static int pool_peek(void *stack, void *out)
+{
+    return stack_pool_peek(stack, out) == STACK_OK;
+}
+
+static void pool_clear(void *stack)
+{
+    stack_pool_clear(stack);
+}
+
+static void pool_destroy(void *stack)
+{
+    stack_pool_destroy(stack);
+}
+
+static void *dyn_create(size_t depth, size_t block_size)
+{
+    (void) depth;
+    (void) block_size;
+    StackDyn *stack = NULL;
+    return stack_dyn_init(&stack, NULL, NULL) == STACK_OK ? stack : NULL;
+}
+
+static void *dyn_copy(const void *data)
+{
+    void *copy = malloc(copy_size);
+    if (copy)
+        memcpy(copy, data, copy_size);
+    return copy;
+}
+
+static void *dyn_deep_create(size_t depth, size_t block_size)
+{
+    (void) depth;
+    copy_size = block_size;
+    StackDyn *stack = NULL;
+    return stack_dyn_init(&stack, dyn_copy, free) == STACK_OK ? stack : NULL;
+}
+
+static void *dyn_sized_create(size_t depth, size_t block_size)
+{
+    (void) depth;
+    StackDyn *stack = NULL;
+    return stack_dyn_init_sized(&stack, block_size) == STACK_OK ? stack : NULL;
+}
+
+static int dyn_push(void *stack, const void *data)
+{
+    return stack_dyn_push(stack, data) == STACK_OK;
+}
+
+static int dyn_pop(void *stack, void *out)
+{
+    return stack_dyn_pop(stack, out) == STACK_OK;
+}
+
+// The popped copy is owned by the caller, copy it out and free it.
+static int dyn_deep_pop(void *stack, void *out)
+{
+    void *data = NULL;
+    if (stack_dyn_pop(stack, &data) != STACK_OK)
+        return 0;
+    memcpy(out, data, copy_size);
+    free(data);
+    return 1;
+}
+
+static int dyn_sized_pop(void *stack, void *out)
+{
+    return stack_dyn_pop_into(stack, out) == STACK_OK;
+}
+
+static int dyn_peek(void *stack, void *out)
+{
+    return stack_dyn_peek(stack, out) == STACK_OK;
+}
+
+static void dyn_clear(void *stack)
+{
+    stack_dyn_clear(stack);
+}
+
+static void dyn_destroy(void *stack)
+{
+    stack_dyn_destroy(stack);
+}
+
+// Raw array baseline: a bounded array with no checks beyond the bounds.
+typedef struct {
+    unsigned char *blocks;
+    size_t size;
+    size_t capacity;
+    size_t block_size;
+} RawArray;
+
+static void *array_create(size_t depth, size_t block_size)
+{
+    RawArray *array = malloc(sizeof(RawArray));
+    if (!array)
+        return NULL;
+    array->blocks = malloc(depth * block_size);
+    if (!array->blocks)
+    {
+        free(array);
+        return NULL;
+    }
+    array->size = 0;
+    array->capacity = depth;
+    array->block_size = block_size;
+    return array;
+}
+
+static int array_push(void *stack, const void *data)
+{
+    RawArray *array = stack;
+    if (array->size == array->capacity)
+        return 0;
+    memcpy(array->blocks + array->size++ * array->block_size, data, array->block_size);
+    return 1;
+}
+
+static int array_pop(void *stack, void *out)
+{
+    RawArray *array = stack;
+    if (!array->size)
+        return 0;
+    memcpy(out, array->blocks + --array->size * array->block_size, array->block_size);
+    return 1;
+}
+
+static int array_peek(void *stack, void *out)
+{
+    RawArray *array = stack;
+    if (!array->size)
+        return 0;
+    memcpy(out, array->blocks + (array->size - 1) * array->block_size, array->block_size);
+    return 1;
+}
+
+static void array_clear(void *stack)
+{
+    ((RawArray *) stack)->size = 0;
+}
+
+static void array_destroy(void *stack)
+{
+    free(((RawArray *) stack)->blocks);
+    free(stack);
+}
+
+// Raw malloc baseline: a linked list with one allocation per element.
+typedef struct raw_node {
+    struct raw_node *next;
+    unsigned char block[];
+} RawNode;
+
+typedef struct {
+    RawNode *top;
+    size_t block_size;
+} RawList;
+
+static void *list_create(size_t depth, size_t block_size)
+{
+    (void) depth;
+    RawList *list = malloc(sizeof(RawList));
+    if (list)
+    {
+        list->top = NULL;
+        list->block_size = block_size;
+    }
+    return list;
+}
+
+static int list_push(void *stack, const void *data)
+{
+    RawList *list = stack;
+    RawNode *node = malloc(sizeof(RawNode) + list->block_size);
+    if (!node)
+        return 0;
+    memcpy(node->block, data, list->block_size);
+    node->next = list->top;
+    list->top = node;
+    return 1;
+}
+
+static int list_pop(void *stack, void *out)
+{
+    RawList *list = stack;
+    RawNode *node = list->top;
+    if (!node)
+        return 0;
+    memcpy(out, node->block, list->block_size);
+    list->top = node->next;
+    free(node);
+    return 1;
+}
+
+static int list_peek(void *stack, void *out)
+{
+    RawList *list = stack;
+    if (!list->top)
+        return 0;
+    memcpy(out, list->top->block, list->block_size);
+    return 1;
+}
+
+static void list_clear(void *stack)
+{
+    RawList *list = stack;
+    while (list->top)
+    {
+        RawNode *next = list->top->next;
+        free(list->top);
+        list->top = next;
+    }
+}
+
+static void list_destroy(void *stack)
+{
+    list_clear(stack);
+    free(stack);
+}
+
+static const BenchBackend backends[] = {
+    {"pool", true, pool_create, pool_push, pool_pop, pool_peek, pool_clear, pool_destroy},
+    {"dyn", false, dyn_create, dyn_push, dyn_pop, dyn_peek, dyn_clear, dyn_destroy},
+    {"dyn_deep", true, dyn_deep_create, dyn_push, dyn_deep_pop, dyn_peek, dyn_clear, dyn_destroy},
+    {"dyn_sized", true, dyn_sized_create, dyn_push, dyn_sized_pop, dyn_peek, dyn_clear, dyn_destroy},
+    {"array", true, array_create, array_push, array_pop, array_peek, array_clear, array_destroy},
+    {"malloc", true, list_create, list_push, list_pop, list_peek, list_clear, list_destroy},
+};
+
+// ---- Cases ----
+
+static size_t rounds_for(size_t depth)
+{
+    return depth >= MIN_OPS ? 1 : (MIN_OPS + depth - 1) / depth;
+}
+
+static void fill(const BenchBackend *backend, void *stack, size_t depth)
+{
+    for (size_t i = 0; i < depth; ++i)
+        backend->push(stack, source);
+}
+
+static uint64_t case_push_pop(const BenchBackend *backend, size_t depth, size_t block_size,
+                              size_t *out_ops)
+{
+    void *stack = backend->create(depth, block_size);
+    if (!stack)
+        return 0;
+
+    size_t rounds = rounds_for(depth);
+    uint64_t start = bench_now_ns();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        fill(backend, stack, depth);
+        while (backend->pop(stack, sink))
+            ;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    backend->destroy(stack);
+    *out_ops = 2 * depth * rounds;
+    return elapsed;
+}
+
+static uint64_t case_peek(const BenchBackend *backend, size_t depth, size_t block_size,
+                          size_t *out_ops)
+{
+    void *stack = backend->create(depth, block_size);
+    if (!stack)
+        return 0;
+    fill(backend, stack, depth);
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < MIN_OPS; ++i)
+        backend->peek(stack, sink);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    backend->destroy(stack);
+    *out_ops = MIN_OPS;
+    return elapsed;
+}
+
+// Time of one clear of a stack filled to depth.
+static uint64_t case_clear(const BenchBackend *backend, size_t depth, size_t block_size,
+                           size_t *out_ops)
+{
+    void *stack = backend->create(depth, block_size);
+    if (!stack)
+        return 0;
+
+    size_t rounds = rounds_for(depth) / 16 + 1;
+    uint64_t elapsed = 0;
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        fill(backend, stack, depth);
+        uint64_t start = bench_now_ns();
+        backend->clear(stack);
+        elapsed += bench_now_ns() - start;
+    }
+
+    backend->destroy(stack);
+    *out_ops = rounds;
+    return elapsed;
+}
+
+// Time of one destroy of a stack filled to depth.
+static uint64_t case_destroy(const BenchBackend *backend, size_t depth, size_t block_size,
+                             size_t *out_ops)
+{
+    size_t rounds = rounds_for(depth) / 16 + 1;
+    uint64_t elapsed = 0;
+
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        void *stack = backend->create(depth, block_size);
+        if (!stack)
+            return 0;
+        fill(backend, stack, depth);
+        uint64_t start = bench_now_ns();
+        backend->destroy(stack);
+        elapsed += bench_now_ns() - start;
+    }
+
+    *out_ops = rounds;
+    return elapsed;
+}
+
+// Random pushes and pops around half the depth, as in a depth-first search.
+static uint64_t case_mixed(const BenchBackend *backend, size_t depth, size_t block_size,
+                           size_t *out_ops)
+{
+    void *stack = backend->create(depth, block_size);
+    if (!stack)
+        return 0;
+    size_t size = depth / 2;
+    fill(backend, stack, size);
+
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < MIN_OPS; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        if ((size < depth && (state & 1)) || size == 0)
+            size += (size_t) backend->push(stack, source);
+        else
+            size -= (size_t) backend->pop(stack, sink);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    backend->destroy(stack);
+    *out_ops = MIN_OPS;
+    return elapsed;
+}
+
+static const BenchCase cases[] = {
+    {"push_pop", case_push_pop},
+    {"peek", case_peek},
+    {"clear", case_clear},
+    {"destroy", case_destroy},
+    {"mixed", case_mixed},
+};
+
+// ---- Reporting ----
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples.
+static double percentile(const double *sorted, size_t count, double p)
+{
+    size_t rank = (size_t) (p * (double) count + 0.999999);
+    return sorted[rank ? rank - 1 : 0];
+}
+
+static BenchStats summarize(double *samples, size_t count)
+{
+    BenchStats stats;
+    qsort(samples, count, sizeof(double), compare_double);
+
+    stats.min = samples[0];
+    stats.max = samples[count - 1];
+    stats.median = count % 2 ? samples[count / 2]
+                             : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+    stats.p90 = percentile(samples, count, 0.90);
+    stats.p99 = percentile(samples, count, 0.99);
+    return stats;
+}
+
+static void print_header(BenchFormat format)
+{
+    if (format == FORMAT_CSV)
+        printf("case,backend,block_size,depth,reps,ops,min_ns,median_ns,p90_ns,p99_ns,max_ns,median_mops\n");
+    else if (format == FORMAT_JSON)
+        printf("[\n");
+    else
+        printf("%-9s %-9s %6s %9s %5s %10s %10s %10s %10s %10s %10s\n", "case", "backend",
+               "block", "depth", "reps", "min ns", "median ns", "p90 ns", "p99 ns", "max ns",
+               "Mops/s");
+}
+
+static void print_row(BenchFormat format, bool first, const char *name, const char *backend,
+                      size_t block_size, size_t depth, size_t reps, size_t ops,
+                      const BenchStats *stats)
+{
+    double mops = stats->median > 0 ? 1e3 / stats->median : 0.0;
+
+    if (format == FORMAT_CSV)
+        printf("%s,%s,%zu,%zu,%zu,%zu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", name, backend,
+               block_size, depth, reps, ops, stats->min, stats->median, stats->p90, stats->p99,
+               stats->max, mops);
+    else if (format == FORMAT_JSON)
+        printf("%s  {\"case\": \"%s\", \"backend\": \"%s\", \"block_size\": %zu, \"depth\": %zu, "
+               "\"reps\": %zu, \"ops\": %zu, \"min_ns\": %.3f, \"median_ns\": %.3f, "
+               "\"p90_ns\": %.3f, \"p99_ns\": %.3f, \"max_ns\": %.3f, \"median_mops\": %.3f}",
+               first ? "" : ",\n", name, backend, block_size, depth, reps, ops, stats->min,
+               stats->median, stats->p90, stats->p99, stats->max, mops);
+    else
+        printf("%-9s %-9s %6zu %9zu %5zu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", name,
+               backend, block_size, depth, reps, stats->min, stats->median, stats->p90,
+               stats->p99, stats->max, mops);
+}
+
+static void print_footer(BenchFormat format)
+{
+    if (format == FORMAT_JSON)
+        printf("\n]\n");
+}
+
+// ---- Command line ----
+
+// Parses a comma-separated list of positive numbers, returns their count or 0.
+static size_t parse_list(const char *text, size_t *values)
+{
+    size_t count = 0;
+    char *end = NULL;
+
+    while (*text && count < MAX_VALUES)
+    {
+        values[count] = strtoull(text, &end, 10);
+        if (end == text || values[count] == 0)
+            return 0;
+        ++count;
+        text = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',')
+            return 0;
+    }
+
+    return count;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s [-f text|csv|json] [-r reps] [-s sizes] [-d depths] "
+            "[-b backend] [-c case] [-t rate]\n"
+            "  -f  output format (text)\n"
+            "  -r  repetitions per measurement (5)\n"
+            "  -s  comma-separated block sizes, at most %d bytes (8,64,256)\n"
+            "  -d  comma-separated depths (1024,65536)\n"
+            "  -b  run only this backend: pool, dyn, dyn_deep, dyn_sized, array,\n"
+            "      malloc\n"
+            "  -c  run only this case: push_pop, peek, clear, destroy, mixed\n"
+            "  -t  time one operation in rate (needs STACK_ENABLE_TRACE)\n",
+            program, MAX_BLOCK_SIZE);
+}
+
+int main(int argc, char **argv)
+{
+    BenchFormat format = FORMAT_TEXT;
+    size_t reps = 5;
+    size_t sizes[MAX_VALUES] = {8, 64, 256};
+    size_t size_count = 3;
+    size_t depths[MAX_VALUES] = {1024, 65536};
+    size_t depth_count = 2;
+    const char *only_backend = NULL;
+    const char *only_case = NULL;
+    size_t trace_rate = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "f:r:s:d:b:c:t:h")) != -1)
+    {
+        switch (option)
+        {
+            case 'f':
+                if (strcmp(optarg, "csv") == 0)
+                    format = FORMAT_CSV;
+                else if (strcmp(optarg, "json") == 0)
+                    format = FORMAT_JSON;
+                else if (strcmp(optarg, "text") == 0)
+                    format = FORMAT_TEXT;
+                else
+                {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'r':
+                reps = strtoull(optarg, NULL, 10);
+                break;
+            case 's':
+                size_count = parse_list(optarg, sizes);
+                break;
+            case 'd':
+                depth_count = parse_list(optarg, depths);
+                break;
+            case 'b':
+                only_backend = optarg;
+                break;
+            case 'c':
+                only_case = optarg;
+                break;
+            case 't':
+                trace_rate = strtoull(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+                return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    bool sizes_valid = size_count > 0;
+    for (size_t s = 0; s < size_count; ++s)
+        sizes_valid = sizes_valid && sizes[s] <= MAX_BLOCK_SIZE;
+
+    if (reps == 0 || !sizes_valid || depth_count == 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (trace_rate && stack_trace_set_rate(trace_rate) != STACK_OK)
+    {
+        fprintf(stderr, "-t: the library is built without STACK_ENABLE_TRACE\n");
+        return EXIT_FAILURE;
+    }
+
+    double *samples = malloc(reps * sizeof(double));
+    if (!samples)
+        return EXIT_FAILURE;
+    memset(source, 0x5a, sizeof(source));
+
+    bool first = true;
+    print_header(format);
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c)
+    {
+        if (only_case && strcmp(only_case, cases[c].name) != 0)
+            continue;
+
+        for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b)
+        {
+            const BenchBackend *backend = &backends[b];
+            if (only_backend && strcmp(only_backend, backend->name) != 0)
+                continue;
+
+            // A backend storing pointers runs once, with the size of a pointer
+            size_t backend_sizes = backend->sized ? size_count : 1;
+
+            for (size_t s = 0; s < backend_sizes; ++s)
+            {
+                size_t block_size = backend->sized ? sizes[s] : sizeof(void *);
+
+                for (size_t d = 0; d < depth_count; ++d)
+                {
+                    size_t ops = 0;
+
+                    // The first run warms the allocator and the caches up
+                    if (cases[c].run(backend, depths[d], block_size, &ops) == 0 && ops == 0)
+                    {
+                        fprintf(stderr, "%s/%s: stack initialization failed!\n",
+                                cases[c].name, backend->name);
+                        free(samples);
+                        return EXIT_FAILURE;
+                    }
+
+                    for (size_t r = 0; r < reps; ++r)
+                    {
+                        uint64_t ns = cases[c].run(backend, depths[d], block_size, &ops);
+                        samples[r] = (double) ns / (double) ops;
+                    }
+
+                    BenchStats stats = summarize(samples, reps);
+                    print_row(format, first, cases[c].name, backend->name, block_size,
+                              depths[d], reps, ops, &stats);
+                    first = false;
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    print_footer(format);
+    free(samples);
+    return 0;
+}
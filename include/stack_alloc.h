@@ -0,0 +1,102 @@
+/**
+ * @file stack_alloc.h
+ * @brief Pluggable allocator for StackPool and StackDyn.
+ *
+ * A StackAllocator routes the memory of a stack (the stack structure,
+ * the pool and its growth, slabs and chunks) to the caller's allocator.
+ * The sizes passed back to free and realloc are the sizes requested, so
+ * sized deallocation (jemalloc sdallocx and the like) can be used.
+ * Memory returned by alloc must be aligned for any type and need not be
+ * zeroed. The stack keeps a copy of the allocator, the context must
+ * outlive the stack.
+ *
+ * Mapped, reserved and aligned pools manage their memory themselves and
+ * always use stack_allocator_malloc for the structure.
+ */
+
+#ifndef STACK_ALLOC_H
+#define STACK_ALLOC_H
+
+#include <stddef.h>
+#include <stack_errors.h>
+
+// Allocator interface
+typedef struct {
+    void *(*alloc)(void *ctx, size_t size);                 // NULL on failure
+    void *(*realloc)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free)(void *ctx, void *ptr, size_t size);        // ptr may be NULL
+    void *ctx;                                              // Passed to every call
+} StackAllocator;
+
+// The default allocator: malloc, realloc and free
+extern const StackAllocator stack_allocator_malloc;
+
+// Block of a bump-pointer arena
+typedef struct stack_arena_block {
+    struct stack_arena_block *prev;     // Older block
+    size_t size;                        // Bytes available to allocations
+} StArenaBlock;
+
+// Bump-pointer arena, everything allocated from it is freed at once
+typedef struct {
+    StArenaBlock *block;    // Newest block, allocations are carved from it
+    size_t used;            // Bytes used in the newest block
+    size_t block_size;      // Size of a new block, larger requests get their own block
+    void *last;             // Latest allocation, it can grow in place
+} StackArena;
+
+/**
+ * @brief Prepares an empty arena.
+ *
+ * Blocks are allocated with malloc when the arena runs out of room.
+ *
+ * @param arena Pointer to the arena.
+ * @param block_size Size of one block in bytes.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The arena pointer is NULL.
+ *          -STACK_INVALID_ARGS: The block_size parameter is zero.
+ */
+StackError stack_arena_init(StackArena *arena, size_t block_size);
+
+/**
+ * @brief Frees everything allocated from the arena.
+ *
+ * The oldest block is kept for the next allocations. Destroy the stacks
+ * using the arena first: their memory is only returned here, but destroy
+ * also releases the readiness descriptor and the statistics and tracing
+ * state.
+ *
+ * @param arena Pointer to the arena.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The arena pointer is NULL.
+ */
+StackError stack_arena_reset(StackArena *arena);
+
+/**
+ * @brief Frees all blocks of the arena.
+ *
+ * @param arena Pointer to the arena.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The arena pointer is NULL.
+ */
+StackError stack_arena_destroy(StackArena *arena);
+
+/**
+ * @brief Gets an allocator carving memory out of the arena.
+ *
+ * Its free does nothing and its realloc grows the latest allocation in
+ * place when the block has room, copying otherwise.
+ *
+ * @param arena Pointer to the arena.
+ * @param out_allocator Pointer to a variable in which the allocator will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The arena pointer is NULL.
+ *          -STACK_NULL_OUT: The out_allocator pointer is NULL.
+ */
+StackError stack_arena_allocator(StackArena *arena, StackAllocator *out_allocator);
+
+#endif // STACK_ALLOC_H
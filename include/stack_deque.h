@@ -0,0 +1,135 @@
+/**
+ * @file stack_deque.h
+ * @brief Work-stealing deque of fixed-size blocks (Chase-Lev).
+ *
+ * Blocks are stored as in StackPool: block_size bytes each, in slots
+ * rounded up to whole words. A slot may be read by a thief while the
+ * owner writes it again, so push and steal copy it with relaxed atomic
+ * word and byte accesses; pop and growth are never concurrent with a
+ * write and use the kernel selected by stack_pool_copy_kernel(). The
+ * owning thread pushes and pops at the bottom like a LIFO stack, other
+ * threads steal the oldest blocks from the top. The circular buffer
+ * doubles when it is full; replaced buffers are kept until the deque
+ * is destroyed because a thief may still be reading from them.
+ */
+
+#ifndef STACK_DEQUE_H
+#define STACK_DEQUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <stack_errors.h>
+#include <stack_pool.h>
+
+// Size of a cache line, used to keep the deque ends apart.
+#ifndef STACK_CACHE_LINE
+#define STACK_CACHE_LINE 64
+#endif
+
+// Circular buffer of blocks.
+typedef struct stack_deque_buffer {
+    size_t capacity;                    // Number of blocks, a power of two
+    struct stack_deque_buffer *prev;    // Replaced buffer, kept for late thieves
+    _Alignas(uintptr_t) byte blocks[];  // capacity * stride bytes
+} StDequeBuffer;
+
+// Definition of the work-stealing deque
+typedef struct {
+    _Alignas(STACK_CACHE_LINE) _Atomic int64_t top;     // Index of the oldest block, advanced by thieves
+    _Alignas(STACK_CACHE_LINE) _Atomic int64_t bottom;  // Index of the next free block, owned by the owner
+    _Atomic(StDequeBuffer *) buffer;    // Current buffer
+    size_t block_size;                  // The size of one element in bytes
+    size_t stride;                      // Distance between blocks, block_size in whole words
+    stack_block_copy copy_block;        // Copy kernel selected for block_size
+} StackDeque;
+
+/**
+ * @brief Creates a work-stealing deque.
+ *
+ * @param deque Pointer to a pointer of type StackDeque
+ * to bind to the new deque.
+ * @param capacity Initial number of elements, rounded up to a power of two.
+ * @param block_size The size of one element in bytes.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The deque pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity parameter or the block_size parameter is zero or too large.
+ *          -STACK_ALLOC_FAILED: Failed to allocate the required memory.
+ */
+StackError stack_deque_init(StackDeque **deque, size_t capacity, size_t block_size);
+
+/**
+ * @brief Destroys the deque and frees all allocated memory.
+ *
+ * Must not be called while other threads use the deque.
+ *
+ * @param deque Pointer to the deque.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The deque pointer is NULL.
+ */
+StackError stack_deque_destroy(StackDeque *deque);
+
+/**
+ * @brief Pushes an element at the bottom. Owner thread only.
+ *
+ * @param deque Pointer to the deque.
+ * @param data Pointer to the data.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The deque pointer is NULL.
+ *          -STACK_NULL_DATA: The data pointer is NULL.
+ *          -STACK_ALLOC_FAILED: Failed to grow the buffer.
+ */
+StackError stack_deque_push(StackDeque *deque, const void *data);
+
+/**
+ * @brief Pops the newest element from the bottom. Owner thread only.
+ *
+ * @param deque Pointer to the deque.
+ * @param out_data Pointer to a variable into which
+ * the extracted value will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The deque pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The deque is empty or the last element was stolen.
+ */
+StackError stack_deque_pop(StackDeque *deque, void *out_data);
+
+/**
+ * @brief Steals the oldest element from the top. Safe to call from any thread.
+ *
+ * The call retries while other thieves win the race for the same
+ * element, so it fails only when the deque is empty. The block is staged
+ * and out_data is written only on success; blocks larger than 256 bytes
+ * are staged in a heap buffer.
+ *
+ * @param deque Pointer to the deque.
+ * @param out_data Pointer to a variable into which
+ * the extracted value will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The deque pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The deque is empty.
+ *          -STACK_ALLOC_FAILED: No memory to stage a large block.
+ */
+StackError stack_deque_steal(StackDeque *deque, void *out_data);
+
+/**
+ * @brief Gets the number of elements in the deque.
+ *
+ * The value is exact only when no other thread is stealing.
+ *
+ * @param deque Pointer to the deque.
+ * @param out_size Pointer to a variable in which the size will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The deque pointer is NULL.
+ *          -STACK_NULL_OUT: The out_size pointer is NULL.
+ */
+StackError stack_deque_size(const StackDeque *deque, size_t *out_size);
+
+#endif // STACK_DEQUE_H
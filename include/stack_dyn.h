@@ -12,6 +12,10 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stack_errors.h>
+#include <stack_alloc.h>
+#include <stack_event.h>
+#include <stack_stats.h>
+#include <stack_trace.h>
 
 /**
  * @typedef copy
@@ -30,18 +34,53 @@ typedef void *(*stack_copy_data)(const void *data);
  */
 typedef void (*stack_destroy_data)(void *data);
 
+// Number of nodes carved out of a single slab.
+#define STACK_DYN_SLAB_NODES 256
+
+// Number of element pointers stored in a single chunk (1 KiB per chunk).
+#define STACK_DYN_CHUNK_ITEMS 127
+
 // The structure represents a stack node.
 typedef struct stack_node {
     void *data;
     struct stack_node *next;
 } StNode;
 
+// The structure represents a slab of stack nodes owned by the stack.
+typedef struct stack_slab {
+    struct stack_slab *next;
+    StNode nodes[STACK_DYN_SLAB_NODES];
+} StSlab;
+
+// The structure represents a chunk of element pointers (chunked storage).
+typedef struct stack_chunk {
+    struct stack_chunk *prev;
+    void *items[STACK_DYN_CHUNK_ITEMS];
+} StChunk;
+
 // The structure represents a stack.
 typedef struct stack_dyn {
     StNode *top;
     size_t size;
     stack_copy_data copy;
     stack_destroy_data destroy;
+    StNode *free_nodes;     // Popped nodes available for reuse
+    StSlab *slabs;          // Slabs owned by the stack, the newest first
+    size_t slab_used;       // Number of nodes carved out of the newest slab
+    bool chunked;           // Elements are stored in chunks instead of nodes
+    StChunk *chunk;         // Top chunk (chunked storage)
+    size_t chunk_used;      // Number of elements in the top chunk
+    StChunk *spare_chunk;   // Emptied chunk kept for reuse
+    size_t elem_size;       // Size of the payload stored inline in each node (sized mode)
+    size_t node_size;       // Distance between the nodes of a slab (sized mode)
+    StStackEvent event;     // Readiness descriptor, disabled by default
+    StackAllocator allocator;   // Memory of the structure, slabs and chunks
+#ifdef STACK_ENABLE_STATS
+    StStackCounters stats;  // Operation counters
+#endif
+#ifdef STACK_ENABLE_TRACE
+    StStackTrace trace;     // Latency sampling
+#endif
 } StackDyn;
 
 /**
@@ -62,6 +101,71 @@ typedef struct stack_dyn {
  */
 StackError stack_dyn_init(StackDyn **stack, stack_copy_data copy, stack_destroy_data destroy);
 
+/**
+ * @brief Creates a new stack with chunked storage.
+ *
+ * Element pointers are stored in arrays of STACK_DYN_CHUNK_ITEMS
+ * linked together, which costs about one pointer per element and keeps
+ * neighbouring elements adjacent in memory. The stack is used through
+ * the same functions as a stack created by stack_dyn_init().
+ *
+ * @param stack Pointer to a pointer of type StackDyn to which
+ * to attach the new stack.
+ * @param copy Function to copy of data stack elements.
+ * @param destroy Function to free data of a stack elements.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: One function (copy or destroy) is passed.
+ *          -STACK_ALLOC_FAILED: Memory allocation error.
+ */
+StackError stack_dyn_init_chunked(StackDyn **stack, stack_copy_data copy, stack_destroy_data destroy);
+
+/**
+ * @brief Creates a new stack storing fixed-size elements inside its nodes.
+ *
+ * Each node carries a copy of the element right after its header, so a
+ * push copies elem_size bytes into a slab slot instead of allocating a
+ * node and a copy. Elements are taken out with stack_dyn_pop_into(),
+ * which copies them to a buffer and recycles the node; stack_dyn_pop()
+ * and stack_dyn_pop_n() are refused. Peek returns a pointer to the
+ * element inside the node, valid until it is popped. The payload is
+ * aligned for any type.
+ *
+ * @param stack Pointer to a pointer of type StackDyn to which
+ * to attach the new stack.
+ * @param elem_size The size of one element in bytes.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The elem_size parameter is zero or too large.
+ *          -STACK_ALLOC_FAILED: Memory allocation error.
+ */
+StackError stack_dyn_init_sized(StackDyn **stack, size_t elem_size);
+
+/**
+ * @brief Creates a new stack whose memory comes from an allocator.
+ *
+ * The structure, slabs and chunks are allocated through the allocator;
+ * the element copies are left to the copy function.
+ *
+ * @param stack Pointer to a pointer of type StackDyn to which
+ * to attach the new stack.
+ * @param copy Function to copy of data stack elements.
+ * @param destroy Function to free data of a stack elements.
+ * @param chunked Store elements in chunks as stack_dyn_init_chunked() does.
+ * @param allocator Allocator to use, it is copied.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer or the allocator pointer is NULL.
+ *          -STACK_INVALID_ARGS: One function (copy or destroy) is passed
+ *          or a function of the allocator is missing.
+ *          -STACK_ALLOC_FAILED: Memory allocation error.
+ */
+StackError stack_dyn_init_allocator(StackDyn **stack, stack_copy_data copy,
+                                    stack_destroy_data destroy, bool chunked,
+                                    const StackAllocator *allocator);
+
 /**
  * @brief Destroys the stack and frees all allocated memory.
  *
@@ -77,6 +181,10 @@ StackError stack_dyn_destroy(StackDyn *stack);
 /**
  * @brief Removes all stack elements and clears the allocated memory.
  *
+ * Nodes are released together with the slabs they were carved from,
+ * the list is walked only when a destroy function is set. With chunked
+ * storage the destroy function is applied array by array.
+ *
  * @param stack Pointer to the stack.
  * @return StackError:
  *          -STACK_OK: The operation was successful.
@@ -87,10 +195,15 @@ StackError stack_dyn_clear(StackDyn *stack);
 /**
  * @brief Pushes an element onto the stack.
  *
+ * The node is taken from the list of popped nodes or carved out of
+ * a slab of STACK_DYN_SLAB_NODES nodes, so the allocator is called
+ * once per slab rather than once per element.
+ *
  * @param stack Pointer to the stack.
  * @param data Pointer to the data to push,
  * may be NULL only when working with pointers (shallow copyng),
- * otherwise an add error will occur.
+ * otherwise an add error will occur. A sized stack copies elem_size
+ * bytes from it.
  * @return StackError:
  *          -STACK_OK: The operation was successful.
  *          -STACK_NULL_PTR: The stack pointer is NULL.
@@ -100,9 +213,56 @@ StackError stack_dyn_clear(StackDyn *stack);
  */
 StackError stack_dyn_push(StackDyn *stack, const void *data);
 
+/**
+ * @brief Pushes an array of elements onto the stack.
+ *
+ * The elements are pushed in order, so data[count - 1] ends up on top.
+ * The new nodes are linked into a run that is attached to the stack
+ * at once, with chunked storage and shallow copying the pointers are
+ * copied into the chunks array by array. On an error the elements
+ * before the failed one stay pushed.
+ *
+ * @param stack Pointer to the stack.
+ * @param data Array of count pointers to the data to push.
+ * @param count Number of elements to push.
+ * @param out_pushed Pointer to a variable into which the number of
+ * pushed elements will be written, may be NULL.
+ * @return StackError:
+ *          -STACK_OK: All elements were pushed.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The data array or data[*out_pushed] is NULL.
+ *          -STACK_ALLOC_FAILED: Memory allocation error at data[*out_pushed].
+ *          -STACK_DATA_COPY_FAILED: Error copying data[*out_pushed].
+ */
+StackError stack_dyn_push_n(StackDyn *stack, void *const *data, size_t count, size_t *out_pushed);
+
+/**
+ * @brief Pops up to count elements from the stack.
+ *
+ * The popped pointers keep their stack order: the former top is written
+ * last, so stack_dyn_pop_n() after stack_dyn_push_n() returns the
+ * original array. When the stack holds fewer than count elements,
+ * all of them are popped into the beginning of out_data.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_data Array of at least count pointers to fill.
+ * @param count Number of elements to pop.
+ * @param out_popped Pointer to a variable into which the number of
+ * popped elements will be written, may be NULL.
+ * @return StackError:
+ *          -STACK_OK: count elements were popped.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_INVALID_ARGS: The stack is sized, use stack_dyn_pop_into().
+ *          -STACK_EMPTY: The stack ran out of elements, *out_popped elements were popped.
+ */
+StackError stack_dyn_pop_n(StackDyn *stack, void **out_data, size_t count, size_t *out_popped);
+
 /**
  * @brief Pops an element from the stack.
  *
+ * The released node is kept for reuse by the next push.
+ *
  * @param stack Pointer to the stack.
  * @param out_data Pointer to a variable into which
  * the retrieved value will be written.
@@ -110,10 +270,25 @@ StackError stack_dyn_push(StackDyn *stack, const void *data);
  *          -STACK_OK: The opearation was successful.
  *          -STACK_NULL_PTR: The stack pointer is NULL.
  *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_INVALID_ARGS: The stack is sized, use stack_dyn_pop_into().
  *          -STACK_EMPTY: The stack is empty.
  */
 StackError stack_dyn_pop(StackDyn *stack, void **out_data);
 
+/**
+ * @brief Removes the top element of a sized stack into a buffer.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_buffer Pointer to a buffer of at least elem_size bytes.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_buffer pointer is NULL.
+ *          -STACK_INVALID_ARGS: The stack was not created by stack_dyn_init_sized().
+ *          -STACK_EMPTY: The stack is empty.
+ */
+StackError stack_dyn_pop_into(StackDyn *stack, void *out_buffer);
+
 /**
  * @brief Retrieves the top element of the stack without removing it.
  *
@@ -154,4 +329,87 @@ StackError stack_dyn_is_empty(const StackDyn *stack, bool *out_empty);
  */
 StackError stack_dyn_size(const StackDyn *stack, size_t *out_size);
 
+/**
+ * @brief Opens a readiness descriptor for the stack.
+ *
+ * The returned eventfd becomes readable when the stack goes from empty
+ * to non-empty or its size falls below the watermark. After one signal
+ * the descriptor stays quiet until stack_dyn_event_ack() is called, so
+ * a burst of operations causes one wakeup. Opening it again only
+ * changes the watermark and re-arms it. Available on Linux only.
+ *
+ * @param stack Pointer to the stack.
+ * @param watermark Size to signal when falling below, 0 to signal
+ * only on the empty to non-empty transition.
+ * @param out_fd Pointer to a variable in which the descriptor will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_fd pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The eventfd could not be created.
+ */
+StackError stack_dyn_event_open(StackDyn *stack, size_t watermark, int *out_fd);
+
+/**
+ * @brief Acknowledges a readiness signal and re-arms the descriptor.
+ *
+ * Transitions that happened while the descriptor was disarmed are not
+ * signaled again, so check the stack after the call.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: No readiness descriptor is open.
+ *          -STACK_UNKNOWN_ERROR: The eventfd could not be read.
+ */
+StackError stack_dyn_event_ack(StackDyn *stack);
+
+/**
+ * @brief Closes the readiness descriptor, also done by destroy.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_dyn_event_close(StackDyn *stack);
+
+/**
+ * @brief Gets the operation counters of the stack.
+ *
+ * Available when the library is built with STACK_ENABLE_STATS. The
+ * allocations counter covers the stack itself, its slabs and chunks,
+ * not the copies made by the copy function; bytes_copied counts the
+ * elements copied in and out of a sized stack.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_stats Pointer to a variable in which the counters will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_stats pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_STATS.
+ */
+StackError stack_dyn_stats(const StackDyn *stack, StackStats *out_stats);
+
+/**
+ * @brief Gets the sampled latency of an operation of the stack.
+ *
+ * Available when the library is built with STACK_ENABLE_TRACE. Only
+ * operations that succeed are timed; all fields are zero until the
+ * first sample.
+ *
+ * @param stack Pointer to the stack.
+ * @param op Operation to report.
+ * @param out_latency Pointer to a variable in which the percentiles will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The operation is unknown.
+ *          -STACK_NULL_OUT: The out_latency pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_TRACE.
+ */
+StackError stack_dyn_latency(const StackDyn *stack, StackTraceOp op, StackLatency *out_latency);
+
 #endif // STACK_DYN_H
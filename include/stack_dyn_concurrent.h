@@ -0,0 +1,195 @@
+/**
+ * @file stack_dyn_concurrent.h
+ * @brief Lock-free stack with dynamic memory allocation for elements
+ * (Treiber stack).
+ *
+ * Push and pop publish and unlink nodes with a CAS on the top pointer.
+ * Popped nodes are reclaimed with hazard pointers: a node is freed only
+ * when no popping thread has it protected, which also rules out the ABA
+ * problem on the top pointer. User-defined functions are used to copy
+ * and free element data, as in stack_dyn.h.
+ *
+ * A stack created with stack_dyn_concurrent_init_elimination() also has
+ * an elimination array. A push or pop whose CAS on top fails tries to
+ * meet an opposite operation in a random slot instead; a matching pair
+ * exchanges the node directly and never touches top. The range of slots
+ * in use widens on collisions and narrows when offers time out.
+ */
+
+#ifndef STACK_DYN_CONCURRENT_H
+#define STACK_DYN_CONCURRENT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stack_errors.h>
+#include <stack_dyn.h>
+
+// Maximum number of threads that can be inside a pop at the same time.
+#define STACK_HP_MAX_RECORDS 128
+
+// Number of retired nodes a record collects before they are scanned.
+#define STACK_HP_RETIRE_THRESHOLD 64
+
+// Number of spins a push waits in an elimination slot for a pop.
+#define STACK_ELIMINATION_SPINS 256
+
+// Size of a cache line, used to keep hot fields apart.
+#ifndef STACK_CACHE_LINE
+#define STACK_CACHE_LINE 64
+#endif
+
+// The structure represents a hazard pointer record.
+typedef struct stack_hazard_record {
+    _Alignas(STACK_CACHE_LINE) _Atomic(StNode *) hazard;   // Node protected by the holder
+    atomic_bool active;     // The record is held by a thread
+    StNode *retired;        // Popped nodes waiting to be freed, chained through data
+    size_t retired_count;   // Number of nodes in the retired list
+} StHazardRecord;
+
+// The structure represents an elimination slot.
+typedef struct stack_elimination_slot {
+    _Alignas(STACK_CACHE_LINE) _Atomic(StNode *) offer;    // Node offered by a push, or a taken marker
+} StEliminationSlot;
+
+// The structure represents a lock-free stack.
+typedef struct stack_dyn_concurrent {
+    _Alignas(STACK_CACHE_LINE) _Atomic(StNode *) top;
+    _Alignas(STACK_CACHE_LINE) atomic_ptrdiff_t size;    // Signed, a pop may be counted first
+    stack_copy_data copy;
+    stack_destroy_data destroy;
+    StEliminationSlot *elimination;     // Elimination array, NULL when disabled
+    size_t elimination_slots;           // Number of slots in the array
+    atomic_size_t elimination_width;    // Number of slots currently in use
+    StHazardRecord records[STACK_HP_MAX_RECORDS];
+} StackDynConcurrent;
+
+/**
+ * @brief Creates a new lock-free stack.
+ *
+ * If the copy and destroy functions are not passed,
+ * then shallow copying (working with pointers) will be used.
+ *
+ * @param stack Pointer to a pointer of type StackDynConcurrent to which
+ * to attach the new stack.
+ * @param copy Function to copy of data stack elements.
+ * @param destroy Function to free data of a stack elements.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: One function (copy or destroy) is passed.
+ *          -STACK_ALLOC_FAILED: Memory allocation error.
+ */
+StackError stack_dyn_concurrent_init(StackDynConcurrent **stack, stack_copy_data copy,
+                                     stack_destroy_data destroy);
+
+/**
+ * @brief Creates a new lock-free stack with an elimination array.
+ *
+ * Suited to workloads where many threads push and pop at similar rates.
+ *
+ * @param stack Pointer to a pointer of type StackDynConcurrent to which
+ * to attach the new stack.
+ * @param copy Function to copy of data stack elements.
+ * @param destroy Function to free data of a stack elements.
+ * @param slots Maximum number of elimination slots.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: One function (copy or destroy) is passed
+ *                               or the slots parameter is zero.
+ *          -STACK_ALLOC_FAILED: Memory allocation error.
+ */
+StackError stack_dyn_concurrent_init_elimination(StackDynConcurrent **stack, stack_copy_data copy,
+                                                 stack_destroy_data destroy, size_t slots);
+
+/**
+ * @brief Destroys the stack and frees all allocated memory.
+ *
+ * Must not be called while other threads use the stack.
+ * The caller is responsible for the dangling pointer.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_dyn_concurrent_destroy(StackDynConcurrent *stack);
+
+/**
+ * @brief Removes all stack elements.
+ *
+ * The elements are detached at once, so the call is safe while other
+ * threads push and pop. Their nodes are reclaimed like popped nodes.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_dyn_concurrent_clear(StackDynConcurrent *stack);
+
+/**
+ * @brief Pushes an element onto the stack. Safe to call from any thread.
+ *
+ * @param stack Pointer to the stack.
+ * @param data Pointer to the data to push,
+ * may be NULL only when working with pointers (shallow copyng).
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The data pointer is NULL.
+ *          -STACK_ALLOC_FAILED: Memory allocation error.
+ *          -STACK_DATA_COPY_FAILED: Error copying data.
+ */
+StackError stack_dyn_concurrent_push(StackDynConcurrent *stack, const void *data);
+
+/**
+ * @brief Pops an element from the stack. Safe to call from any thread.
+ *
+ * The caller owns the returned data. When more than STACK_HP_MAX_RECORDS
+ * threads pop at the same time, the extra threads spin until a hazard
+ * record is released.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_data Pointer to a variable into which
+ * the retrieved value will be written.
+ * @return StackError:
+ *          -STACK_OK: The opearation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+StackError stack_dyn_concurrent_pop(StackDynConcurrent *stack, void **out_data);
+
+/**
+ * @brief Checks if the stack is empty at the moment of the call.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_empty Pointer to a boolean variable to store
+ * the return value.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_empty pointer is NULL.
+ */
+StackError stack_dyn_concurrent_is_empty(const StackDynConcurrent *stack, bool *out_empty);
+
+/**
+ * @brief Gets the size of the stack.
+ *
+ * The value is exact only when no other thread is pushing or popping.
+ * Otherwise it is approximate: a pop may be counted before the push of
+ * the same element, and the size is then reported as zero.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_size Pointer to a variable in which the stack size
+ * will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_size pointer is NULL.
+ */
+StackError stack_dyn_concurrent_size(const StackDynConcurrent *stack, size_t *out_size);
+
+#endif // STACK_DYN_CONCURRENT_H
@@ -7,6 +7,7 @@
 #define STACK_ERRORS_H
 
 #include <stdio.h>
+#include <stack_config.h>
 
 // Error codes
 typedef enum {
@@ -22,23 +23,33 @@ typedef enum {
     STACK_NULL_DATA,        /* The data pointer is NULL (relevant for a stack with a memory pool
                                and a dynamic stack with deep copying). */
     STACK_UNKNOWN_ERROR,    // Unknown error
+    STACK_TIMEOUT,          // The wait timed out (relevant for a blocking stack)
 } StackError;
 
-// Global variable to store the last error
-extern StackError stack_last_error;
+// Last error of the calling thread
+extern _Thread_local StackError stack_last_error;
 
 extern char *str_errors[];
 
-// Function to get tha last error
+// Function to get tha last error of the calling thread,
+// always STACK_OK when the library is built with STACK_NO_LAST_ERROR
 StackError stack_get_last_error(void);
 
+// Records the last error, compiled out when only return codes are used
+#ifdef STACK_NO_LAST_ERROR
+#define STACK_SET_ERROR(err) ((void) 0)
+#else
+#define STACK_SET_ERROR(err) (stack_last_error = (err))
+#endif
+
 // Macro to simplify error checking
 #define STACK_CHECK_ERROR(func_call) \
     do { \
-        stack_last_error = (func_call); \
-        if (stack_last_error != STACK_OK) { \
-            fprintf(stderr, "Error in " #func_call": %s\n", str_errors[stack_last_error]); \
-            return stack_last_error; \
+        StackError stack_check_err = (func_call); \
+        STACK_SET_ERROR(stack_check_err); \
+        if (stack_check_err != STACK_OK) { \
+            fprintf(stderr, "Error in " #func_call": %s\n", str_errors[stack_check_err]); \
+            return stack_check_err; \
         } \
     } while (0)
 
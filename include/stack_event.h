@@ -0,0 +1,52 @@
+/**
+ * @file stack_event.h
+ * @brief Readiness descriptor shared by StackPool and StackDyn.
+ *
+ * An opened event owns an eventfd (Linux) that an epoll loop can watch.
+ * The stack writes to it on two transitions: empty to non-empty, and
+ * falling below the watermark. The signal is edge-triggered and
+ * coalesced: after one write the event is disarmed, and every further
+ * transition is silent until the owner acknowledges the event. A burst
+ * of pushes therefore costs at most one system call.
+ */
+
+#ifndef STACK_EVENT_H
+#define STACK_EVENT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stack_errors.h>
+
+// Readiness state of a stack
+typedef struct {
+    int fd;             // eventfd, -1 when readiness is disabled
+    bool armed;         // The next transition writes to fd
+    size_t watermark;   // Falling below this size is a transition, 0 disables it
+} StStackEvent;
+
+// Puts the event into the disabled state.
+void stack_event_init(StStackEvent *event);
+
+// Creates the eventfd and arms the event.
+StackError stack_event_open(StStackEvent *event, size_t watermark, int *out_fd);
+
+// Drains the eventfd and arms the event again.
+StackError stack_event_ack(StStackEvent *event);
+
+// Closes the eventfd and disables the event.
+void stack_event_close(StStackEvent *event);
+
+// Writes to the eventfd and disarms the event.
+void stack_event_signal(StStackEvent *event);
+
+// Signals the event if the size change is a transition, costs one
+// branch while the event is disabled or disarmed.
+static inline void stack_event_update(StStackEvent *event, size_t old_size, size_t new_size)
+{
+    if (event->armed &&
+        ((old_size == 0 && new_size != 0) ||
+         (old_size >= event->watermark && new_size < event->watermark)))
+        stack_event_signal(event);
+}
+
+#endif // STACK_EVENT_H
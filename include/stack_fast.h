@@ -0,0 +1,238 @@
+/**
+ * @file stack_fast.h
+ * @brief Inline unchecked operations for StackPool and StackDyn.
+ *
+ * The functions expect valid stack and data pointers and do not record
+ * the last error on the fast path, so the compiler can inline them into
+ * hot loops. The fast path covers the common case; everything else
+ * (empty stack, growth, segment and chunk boundaries, deep copying) is
+ * passed on to the checked functions, and so are operations that may
+ * signal an armed readiness descriptor or are due for a latency sample.
+ * Define STACK_FAST_DEBUG to assert the arguments.
+ */
+
+#ifndef STACK_FAST_H
+#define STACK_FAST_H
+
+#include <stddef.h>
+#include <stack_dyn.h>
+#include <stack_pool.h>
+
+#ifdef STACK_FAST_DEBUG
+#include <assert.h>
+#define STACK_FAST_ASSERT(cond) assert(cond)
+#else
+#define STACK_FAST_ASSERT(cond) ((void) 0)
+#endif
+
+/**
+ * @brief Pushes an element without checking the arguments.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @param data Pointer to the data, must not be NULL.
+ * @return StackError: as stack_pool_push().
+ */
+static inline StackError stack_pool_push_unchecked(StackPool *stack, const void *data)
+{
+    STACK_FAST_ASSERT(stack && data);
+
+    byte *next = (byte *) stack->top + stack->stride;
+    if (stack->size && next != (byte *) stack->end && STACK_TRACE_SKIP(stack->trace))
+    {
+        stack->copy_block(next, data, stack->block_size);
+        stack->top = next;
+        ++stack->size;
+        STACK_STAT_ADD(stack->stats, pushes, 1);
+        STACK_STAT_ADD(stack->stats, bytes_copied, stack->block_size);
+        STACK_STAT_MAX(stack->stats, high_water, stack->size + stack->spilled);
+        return STACK_OK;
+    }
+
+    return stack_pool_push(stack, data);
+}
+
+/**
+ * @brief Pops an element without checking the arguments.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @param out_data Pointer to the output block, must not be NULL.
+ * @return StackError: as stack_pool_pop().
+ */
+static inline StackError stack_pool_pop_unchecked(StackPool *stack, void *out_data)
+{
+    STACK_FAST_ASSERT(stack && out_data);
+
+    if (stack->size > 1 && stack->top != stack->base && !stack->event.armed &&
+        STACK_TRACE_SKIP(stack->trace))
+    {
+        stack->copy_block(out_data, stack->top, stack->block_size);
+        stack->top = (byte *) stack->top - stack->stride;
+        --stack->size;
+        STACK_STAT_ADD(stack->stats, pops, 1);
+        STACK_STAT_ADD(stack->stats, bytes_copied, stack->block_size);
+        return STACK_OK;
+    }
+
+    return stack_pool_pop(stack, out_data);
+}
+
+/**
+ * @brief Retrieves the top element without checking the arguments.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @param out_data Pointer to the output block, must not be NULL.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+static inline StackError stack_pool_peek_unchecked(const StackPool *stack, void *out_data)
+{
+    STACK_FAST_ASSERT(stack && out_data);
+
+    if (!stack->size)
+        return STACK_EMPTY;
+
+    stack->copy_block(out_data, stack->top, stack->block_size);
+    return STACK_OK;
+}
+
+/**
+ * @brief Gets the size of the stack without checking the arguments.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @return Number of stack elements.
+ */
+static inline size_t stack_pool_size_unchecked(const StackPool *stack)
+{
+    STACK_FAST_ASSERT(stack);
+
+    return stack->size + stack->spilled;
+}
+
+/**
+ * @brief Pushes an element without checking the arguments.
+ *
+ * The fast path reuses a popped node or a free node of the newest slab
+ * (or a free place in the top chunk) of a stack with shallow copying.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @param data Pointer to the data to push.
+ * @return StackError: as stack_dyn_push().
+ */
+static inline StackError stack_dyn_push_unchecked(StackDyn *stack, const void *data)
+{
+    STACK_FAST_ASSERT(stack);
+
+    if (!stack->copy && !stack->elem_size && !stack->event.armed && STACK_TRACE_SKIP(stack->trace))
+    {
+        if (stack->chunked)
+        {
+            if (stack->chunk && stack->chunk_used < STACK_DYN_CHUNK_ITEMS)
+            {
+                stack->chunk->items[stack->chunk_used++] = (void *) data;
+                ++stack->size;
+                STACK_STAT_ADD(stack->stats, pushes, 1);
+                STACK_STAT_MAX(stack->stats, high_water, stack->size);
+                return STACK_OK;
+            }
+        }
+        else
+        {
+            StNode *node = stack->free_nodes;
+            if (node)
+                stack->free_nodes = node->next;
+            else if (stack->slabs && stack->slab_used < STACK_DYN_SLAB_NODES)
+                node = &stack->slabs->nodes[stack->slab_used++];
+
+            if (node)
+            {
+                node->data = (void *) data;
+                node->next = stack->top;
+                stack->top = node;
+                ++stack->size;
+                STACK_STAT_ADD(stack->stats, pushes, 1);
+                STACK_STAT_MAX(stack->stats, high_water, stack->size);
+                return STACK_OK;
+            }
+        }
+    }
+
+    return stack_dyn_push(stack, data);
+}
+
+/**
+ * @brief Pops an element without checking the arguments.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @param out_data Pointer to the output variable, must not be NULL.
+ * @return StackError: as stack_dyn_pop().
+ */
+static inline StackError stack_dyn_pop_unchecked(StackDyn *stack, void **out_data)
+{
+    STACK_FAST_ASSERT(stack && out_data);
+
+    if (stack->event.armed || stack->elem_size || !STACK_TRACE_SKIP(stack->trace))
+        return stack_dyn_pop(stack, out_data);
+
+    if (stack->chunked)
+    {
+        if (stack->chunk_used > 1)
+        {
+            *out_data = stack->chunk->items[--stack->chunk_used];
+            --stack->size;
+            STACK_STAT_ADD(stack->stats, pops, 1);
+            return STACK_OK;
+        }
+    }
+    else if (stack->top)
+    {
+        StNode *node = stack->top;
+        stack->top = node->next;
+        *out_data = node->data;
+        node->next = stack->free_nodes;
+        stack->free_nodes = node;
+        --stack->size;
+        STACK_STAT_ADD(stack->stats, pops, 1);
+        return STACK_OK;
+    }
+
+    return stack_dyn_pop(stack, out_data);
+}
+
+/**
+ * @brief Retrieves the top element without checking the arguments.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @param out_data Pointer to the output variable, must not be NULL.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+static inline StackError stack_dyn_peek_unchecked(const StackDyn *stack, void **out_data)
+{
+    STACK_FAST_ASSERT(stack && out_data);
+
+    if (!stack->size)
+        return STACK_EMPTY;
+
+    if (stack->chunked)
+        *out_data = stack->chunk->items[stack->chunk_used - 1];
+    else
+        *out_data = stack->top->data;
+    return STACK_OK;
+}
+
+/**
+ * @brief Gets the size of the stack without checking the arguments.
+ *
+ * @param stack Pointer to the stack, must not be NULL.
+ * @return Number of stack elements.
+ */
+static inline size_t stack_dyn_size_unchecked(const StackDyn *stack)
+{
+    STACK_FAST_ASSERT(stack);
+
+    return stack->size;
+}
+
+#endif // STACK_FAST_H
@@ -0,0 +1,142 @@
+/**
+ * @file stack_intrusive.h
+ * @brief Intrusive stack threading caller-owned objects.
+ *
+ * The caller embeds a StackLink in its own structure and pushes the link;
+ * STACK_CONTAINER_OF() turns a popped link back into the structure. The
+ * stack never allocates, copies or frees anything: push and pop relink
+ * one pointer, and splice moves a whole stack onto another in O(1). The
+ * StackIntrusive itself is owned by the caller too, it may live on the
+ * stack or inside another structure.
+ *
+ * A link may be on at most one stack at a time and its object must stay
+ * alive while it is linked. The stack is not thread-safe.
+ */
+
+#ifndef STACK_INTRUSIVE_H
+#define STACK_INTRUSIVE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stack_errors.h>
+
+// Gets the structure of type embedding the member that ptr points to.
+#define STACK_CONTAINER_OF(ptr, type, member) \
+    ((type *) ((char *) (ptr) - offsetof(type, member)))
+
+// Hook embedded in the objects put on an intrusive stack
+typedef struct stack_link {
+    struct stack_link *next;    // Link below, NULL at the bottom
+} StackLink;
+
+// The structure represents an intrusive stack.
+typedef struct stack_intrusive {
+    StackLink *top;
+    StackLink *bottom;  // Last link, kept for splicing
+    size_t size;
+} StackIntrusive;
+
+/**
+ * @brief Prepares an empty intrusive stack.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_intrusive_init(StackIntrusive *stack);
+
+/**
+ * @brief Unlinks all elements.
+ *
+ * The objects are left to the caller, nothing is freed.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_intrusive_clear(StackIntrusive *stack);
+
+/**
+ * @brief Pushes a link onto the stack.
+ *
+ * @param stack Pointer to the stack.
+ * @param link Pointer to the link embedded in the object.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The link pointer is NULL.
+ */
+StackError stack_intrusive_push(StackIntrusive *stack, StackLink *link);
+
+/**
+ * @brief Pops the top link from the stack.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_link Pointer to a variable into which
+ * the popped link will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_link pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+StackError stack_intrusive_pop(StackIntrusive *stack, StackLink **out_link);
+
+/**
+ * @brief Gets the top link without removing it.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_link Pointer to a variable into which
+ * the top link will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_link pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+StackError stack_intrusive_peek(const StackIntrusive *stack, StackLink **out_link);
+
+/**
+ * @brief Moves all links of the source stack on top of the stack.
+ *
+ * The order of the moved links is kept, the top of source becomes the
+ * top of stack. The source is left empty.
+ *
+ * @param stack Pointer to the receiving stack.
+ * @param source Pointer to the stack whose links are moved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack or source pointer is NULL.
+ *          -STACK_INVALID_ARGS: The stack and source are the same stack.
+ */
+StackError stack_intrusive_splice(StackIntrusive *stack, StackIntrusive *source);
+
+/**
+ * @brief Checks if the stack is empty.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_empty Pointer to a boolean variable to store
+ * the return value.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_empty pointer is NULL.
+ */
+StackError stack_intrusive_is_empty(const StackIntrusive *stack, bool *out_empty);
+
+/**
+ * @brief Gets the size of the stack.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_size Pointer to a variable in which the stack size
+ * will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_size pointer is NULL.
+ */
+StackError stack_intrusive_size(const StackIntrusive *stack, size_t *out_size);
+
+#endif // STACK_INTRUSIVE_H
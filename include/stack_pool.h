@@ -11,23 +11,93 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stack_errors.h>
+#include <stack_alloc.h>
+#include <stack_event.h>
+#include <stack_stats.h>
+#include <stack_trace.h>
 
 
 // Represents the minimum memory addressing cell (1 byte)
 typedef unsigned char byte;
 
+/**
+ * @typedef stack_block_copy
+ * @brief Function pointer type for copying one block.
+ *
+ * @param dst Destination of the copy.
+ * @param src Source of the copy.
+ * @param size The size of the block in bytes.
+ */
+typedef void (*stack_block_copy)(void *dst, const void *src, size_t size);
+
+// Growth policy of the memory pool
+typedef enum {
+    STACK_POOL_FIXED = 0,   // The pool never grows, a push into a full stack fails
+    STACK_POOL_DOUBLE,      // The pool is reallocated with double capacity, blocks may move
+    STACK_POOL_SEGMENTED,   // A new segment is added, blocks never move
+    STACK_POOL_SPILL,       // The bottom blocks are moved to a temporary file
+} StackPoolGrowth;
+
+// Memory holding the pool
+typedef enum {
+    STACK_POOL_HEAP = 0,    // Heap memory, freed through the allocator of the stack
+    STACK_POOL_FILE,        // Shared mapping of a file (persistent pool)
+    STACK_POOL_RESERVED,    // Reserved address space committed on demand
+    STACK_POOL_ANONYMOUS,   // Anonymous mapping (explicit huge pages)
+} StackPoolStorage;
+
+// Pages backing an aligned pool
+typedef enum {
+    STACK_POOL_PAGES_DEFAULT = 0,   // Base pages from the heap
+    STACK_POOL_PAGES_TRANSPARENT,   // Heap memory aligned to 2 MiB and advised for transparent huge pages
+    STACK_POOL_PAGES_HUGETLB,       // Explicit huge pages from the reserved pool (MAP_HUGETLB)
+} StackPoolPages;
+
+// Contiguous segment of blocks (segmented growth)
+typedef struct {
+    void *base;         // First block of the segment
+    void *end;          // End of the segment
+} StPoolSegment;
+
 //Definition of the stack structure with a memory pool
 typedef struct {
     void *pool;         // Pointer to the beginning of the memory pool
     void *top;          // Stack top pointer
-    size_t capacity;    // Maximum capacity
+    size_t capacity;    // Current capacity
     size_t block_size;  // The size of one element in bytes
     size_t size;        // Number of stack elements
+    size_t stride;      // Distance between blocks, block_size rounded up to the alignment
+    void *base;         // First block of the memory holding the top block
+    void *end;          // End of the memory holding the top block
+    StackPoolGrowth growth; // Growth policy
+    size_t max_capacity;    // Capacity the pool may grow to
+    StPoolSegment *segments;    // Segments of the pool (segmented growth)
+    size_t segment_count;       // Number of allocated segments
+    size_t segment;             // Index of the segment holding the top block
+    stack_block_copy copy_block;    // Copy kernel selected for block_size
+    StStackEvent event;         // Readiness descriptor, disabled by default
+    StackPoolStorage storage;   // Memory holding the pool
+    void *mapping;              // Start of the mapping (mapped storage)
+    size_t mapping_size;        // Length of the mapping in bytes
+    int spill_fd;               // Temporary file holding spilled blocks (spill growth)
+    size_t spilled;             // Number of blocks in the spill file
+    size_t spill_chunk;         // Number of blocks moved to or from the file at once
+    size_t retain;              // Blocks kept committed after a shrink (reserved storage)
+    StackAllocator allocator;   // Memory of the structure and of a heap pool
+#ifdef STACK_ENABLE_STATS
+    StStackCounters stats;      // Operation counters
+#endif
+#ifdef STACK_ENABLE_TRACE
+    StStackTrace trace;         // Latency sampling
+#endif
 } StackPool;
 
 /**
  * @brief Creates a stack with a memory pool.
  *
+ * The block copy kernel is selected here once: fixed-width copies for
+ * blocks of 1, 2, 4, 8, 16, 32 and 64 bytes, wide copies for larger blocks.
+ *
  * @param stack Pointer to a pointer of type StackPool
  * to bind to the new stack.
  * @param capacity Number of elements the stack can hold.
@@ -40,6 +110,207 @@ typedef struct {
  */
 StackError stack_pool_init(StackPool **stack, size_t capacity, size_t block_size);
 
+/**
+ * @brief Creates a stack with a memory pool that grows on demand.
+ *
+ * When a push finds the stack full, the pool grows by its current
+ * capacity (but not above max_capacity), so the cost of growth is
+ * amortized O(1) per push:
+ *  - STACK_POOL_DOUBLE reallocates the pool, block addresses may change;
+ *  - STACK_POOL_SEGMENTED adds a new segment, block addresses never change.
+ * The pool does not shrink until it is destroyed.
+ *
+ * @param stack Pointer to a pointer of type StackPool
+ * to bind to the new stack.
+ * @param capacity Number of elements the stack can hold initially.
+ * @param block_size The size of one element in bytes.
+ * @param growth Growth policy.
+ * @param max_capacity Hard limit on the number of elements,
+ * zero means the limit is only set by the address space.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity or block_size parameter is zero,
+ *          the growth policy is unknown or max_capacity is less than capacity.
+ *          -STACK_ALLOC_FAILED: Failed to allocate the required memory.
+ */
+StackError stack_pool_init_growable(StackPool **stack, size_t capacity, size_t block_size,
+                                    StackPoolGrowth growth, size_t max_capacity);
+
+/**
+ * @brief Creates a stack whose structure and pool come from an allocator.
+ *
+ * Same as stack_pool_init_growable(), growth goes through the allocator
+ * too: realloc for STACK_POOL_DOUBLE, alloc for new segments. The pool
+ * memory is not zeroed.
+ *
+ * @param stack Pointer to a pointer of type StackPool
+ * to bind to the new stack.
+ * @param capacity Number of elements the stack can hold initially.
+ * @param block_size The size of one element in bytes.
+ * @param growth Growth policy.
+ * @param max_capacity Hard limit on the number of elements,
+ * zero means the limit is only set by the address space.
+ * @param allocator Allocator to use, it is copied.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer or the allocator pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity or block_size parameter is zero,
+ *          the growth policy is unknown, max_capacity is less than capacity
+ *          or a function of the allocator is missing.
+ *          -STACK_ALLOC_FAILED: Failed to allocate the required memory.
+ */
+StackError stack_pool_init_allocator(StackPool **stack, size_t capacity, size_t block_size,
+                                     StackPoolGrowth growth, size_t max_capacity,
+                                     const StackAllocator *allocator);
+
+/**
+ * @brief Creates a stack with a memory pool of aligned blocks.
+ *
+ * Every block starts at a multiple of align: the distance between
+ * blocks (the stride) is block_size rounded up to align and the pool
+ * itself is aligned. With align equal to the cache line size no block
+ * straddles two lines; the padding costs stride - block_size bytes per
+ * block. Batch operations copy block by block when the stride differs
+ * from block_size.
+ *
+ * STACK_POOL_PAGES_TRANSPARENT aligns pools of at least 2 MiB to 2 MiB
+ * and advises the kernel to back them with transparent huge pages, which
+ * it may ignore. STACK_POOL_PAGES_HUGETLB maps explicit huge pages and
+ * fails unless huge pages have been reserved by the administrator.
+ *
+ * The pool never grows.
+ *
+ * @param stack Pointer to a pointer of type StackPool
+ * to bind to the new stack.
+ * @param capacity Number of elements the stack can hold.
+ * @param block_size The size of one element in bytes.
+ * @param align Alignment of every block, a power of two, zero or one
+ * packs the blocks as stack_pool_init() does.
+ * @param pages Pages backing the pool.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity or block_size parameter is zero,
+ *          align is not a power of two or the pages option is unknown.
+ *          -STACK_ALLOC_FAILED: Failed to allocate the required memory.
+ */
+StackError stack_pool_init_aligned(StackPool **stack, size_t capacity, size_t block_size,
+                                   size_t align, StackPoolPages pages);
+
+/**
+ * @brief Creates a stack with a memory pool in reserved address space.
+ *
+ * The address space for capacity blocks is reserved with mmap() and
+ * no memory is touched up front. Pages are made accessible 64 KiB at a
+ * time as the stack grows, and a PROT_NONE guard page follows the last
+ * page of blocks, so running past the pool faults. When checked pops,
+ * drops or a clear leave more than one spare step committed above
+ * max(size, retain) blocks, the pages above are returned to the system
+ * with madvise(MADV_DONTNEED) and made inaccessible again.
+ *
+ * The pool never grows and blocks never move.
+ *
+ * @param stack Pointer to a pointer of type StackPool
+ * to bind to the new stack.
+ * @param capacity Number of elements the stack can hold.
+ * @param block_size The size of one element in bytes.
+ * @param retain Number of elements whose memory is kept when the stack
+ * shrinks (the high-water mark), zero returns all unused pages.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity parameter or the block_size parameter is zero.
+ *          -STACK_ALLOC_FAILED: Failed to reserve the address space.
+ */
+StackError stack_pool_init_reserved(StackPool **stack, size_t capacity, size_t block_size,
+                                    size_t retain);
+
+/**
+ * @brief Creates a stack with a memory pool that spills to disk.
+ *
+ * The pool holds capacity blocks in memory. When a push finds it full,
+ * the oldest half of the blocks is written to an unlinked temporary
+ * file with one sequential write and the rest is moved down. When pops
+ * drain memory to the last block, the newest spilled half is read back
+ * with one read, and the kernel is asked to start reading the half
+ * below it (posix_fadvise(POSIX_FADV_WILLNEED)) so the next refill
+ * finds it in the page cache. The stack size counts spilled blocks.
+ *
+ * The readiness watermark applies to the blocks held in memory.
+ *
+ * @param stack Pointer to a pointer of type StackPool
+ * to bind to the new stack.
+ * @param capacity Number of elements held in memory, at least two.
+ * @param block_size The size of one element in bytes.
+ * @param dir Directory of the temporary file, NULL uses TMPDIR or /tmp.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity parameter is less than two
+ *          or the block_size parameter is zero.
+ *          -STACK_ALLOC_FAILED: Failed to allocate the pool or to create the file.
+ */
+StackError stack_pool_init_spill(StackPool **stack, size_t capacity, size_t block_size,
+                                 const char *dir);
+
+/**
+ * @brief Opens a persistent stack stored in a memory-mapped file.
+ *
+ * A new or empty file is sized for capacity blocks and gets a header.
+ * An existing file is mapped as it is, which takes time independent of
+ * its size; the header gives the capacity and the size at the last
+ * sync. The header is kept in two slots written alternately with a
+ * sequence number and a checksum, so a header torn by a crash falls
+ * back to the previous sync. Blocks written after the last sync may
+ * hold either their old or their new contents after a crash.
+ *
+ * The pool never grows. stack_pool_destroy() syncs and unmaps the file.
+ * A file created by a call that fails is removed.
+ *
+ * @param stack Pointer to a pointer of type StackPool
+ * to bind to the new stack.
+ * @param path Path of the backing file.
+ * @param capacity Number of elements of a new file, ignored for an
+ * existing one.
+ * @param block_size The size of one element in bytes, zero accepts the
+ * block size of an existing file.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer or the path is NULL.
+ *          -STACK_INVALID_ARGS: A new file is requested with zero capacity or
+ *          block_size, or block_size does not match the existing file.
+ *          -STACK_INVALID_TYPE: The file has no valid header.
+ *          -STACK_ALLOC_FAILED: The file could not be opened, sized or mapped.
+ */
+StackError stack_pool_open(StackPool **stack, const char *path, size_t capacity, size_t block_size);
+
+/**
+ * @brief Writes a persistent stack to its file.
+ *
+ * Flushes the blocks, then writes the header into the older of the two
+ * header slots and flushes it, with msync(MS_SYNC) semantics.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_TYPE: The stack is not file-backed.
+ *          -STACK_UNKNOWN_ERROR: msync failed.
+ */
+StackError stack_pool_sync(StackPool *stack);
+
+/**
+ * @brief Selects the block copy kernel for a block size.
+ *
+ * Used by stack_pool_init() and by other containers that store
+ * fixed-size blocks the same way.
+ *
+ * @param block_size The size of one block in bytes.
+ * @return Copy function for blocks of block_size bytes.
+ */
+stack_block_copy stack_pool_copy_kernel(size_t block_size);
+
 /*
  * @brief Clears the stack.
  *
@@ -71,10 +342,55 @@ StackError stack_pool_destroy(StackPool *stack);
  *          -STACK_OK: The operation was successful.
  *          -STACK_NULL_PTR: The stack pointer is NULL.
  *          -STACK_NULL_DATA: The data pointer is NULL.
- *          -STACK_FULL: The stack is full.
+ *          -STACK_FULL: The stack is full and cannot grow.
+ *          -STACK_ALLOC_FAILED: Failed to grow the pool or to write the spill file.
  */
 StackError stack_pool_push(StackPool *stack, const void *data);
 
+/*
+ * @brief Pushes an array of elements onto the stack.
+ *
+ * The elements are copied in order, so data[count - 1] ends up on top.
+ * Contiguous runs of blocks are copied at once. When the stack fills up
+ * (and cannot grow), the elements that fit stay pushed, the rest are not
+ * pushed and the error is returned.
+ *
+ * @param stack Pointer to the stack.
+ * @param data Pointer to an array of count blocks.
+ * @param count Number of elements to push.
+ * @param out_pushed Pointer to a variable into which the number of
+ * pushed elements will be written, may be NULL.
+ * @return StackError:
+ *          -STACK_OK: All elements were pushed.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The data pointer is NULL.
+ *          -STACK_FULL: The stack became full, *out_pushed elements were pushed.
+ *          -STACK_ALLOC_FAILED: Failed to grow the pool, *out_pushed elements were pushed.
+ */
+StackError stack_pool_push_n(StackPool *stack, const void *data, size_t count, size_t *out_pushed);
+
+/*
+ * @brief Pops up to count elements from the stack.
+ *
+ * The popped blocks keep their stack order: the former top is written
+ * last, so stack_pool_pop_n() after stack_pool_push_n() returns the
+ * original array. When the stack holds fewer than count elements,
+ * all of them are popped into the beginning of out_data.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_data Pointer to an array of at least count blocks.
+ * @param count Number of elements to pop.
+ * @param out_popped Pointer to a variable into which the number of
+ * popped elements will be written, may be NULL.
+ * @return StackError:
+ *          -STACK_OK: count elements were popped.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The stack ran out of elements, *out_popped elements were popped.
+ *          -STACK_UNKNOWN_ERROR: Reading the spill file failed, *out_popped elements were popped.
+ */
+StackError stack_pool_pop_n(StackPool *stack, void *out_data, size_t count, size_t *out_popped);
+
 /*
  * @brief Pops an element from the stack.
  *
@@ -86,9 +402,47 @@ StackError stack_pool_push(StackPool *stack, const void *data);
  *          -STACK_NULL_PTR: The stack pointer is NULL.
  *          -STACK_NULL_OUT: The out_data pointer is NULL.
  *          -STACK_EMPTY: The stack is empty.
+ *          -STACK_UNKNOWN_ERROR: Reading the spill file failed, nothing was popped.
  */
 StackError stack_pool_pop(StackPool *stack, void *out_data);
 
+/*
+ * @brief Pushes an element that is built in place.
+ *
+ * The next free block becomes the top of the stack and a pointer to it
+ * is returned, the caller writes block_size bytes into it instead of
+ * copying them from another buffer. The old contents of the block are
+ * left as is.
+ *
+ * The pointer stays valid until the element is popped or dropped, the
+ * stack is cleared or destroyed, or (for STACK_POOL_DOUBLE pools only)
+ * the next push that grows the pool, whichever comes first. In a
+ * STACK_POOL_SPILL pool blocks also move when they spill or are read back.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_slot Pointer to a variable into which the block address
+ * will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_slot pointer is NULL.
+ *          -STACK_FULL: The stack is full and cannot grow.
+ *          -STACK_ALLOC_FAILED: Failed to grow the pool.
+ */
+StackError stack_pool_push_slot(StackPool *stack, void **out_slot);
+
+/*
+ * @brief Removes the top element without copying it out.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ *          -STACK_UNKNOWN_ERROR: Reading the spill file failed, nothing was dropped.
+ */
+StackError stack_pool_drop(StackPool *stack);
+
 /*
  * @brief Retrieves the top element of the stack without removing it.
  *
@@ -103,6 +457,26 @@ StackError stack_pool_pop(StackPool *stack, void *out_data);
  */
 StackError stack_pool_peek(const StackPool *stack, void *out_data);
 
+/*
+ * @brief Gets a pointer to the top element without copying it.
+ *
+ * The pointer follows the same validity rules as the one returned by
+ * stack_pool_push_slot(): it stays valid until the element is popped or
+ * dropped, the stack is cleared or destroyed, a STACK_POOL_DOUBLE pool
+ * grows or a STACK_POOL_SPILL pool moves its blocks. The element may be
+ * modified through it.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_block Pointer to a variable into which the block address
+ * will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_block pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+StackError stack_pool_top_ptr(const StackPool *stack, void **out_block);
+
 /*
  * @brief Checks if the stack is empty.
  *
@@ -129,5 +503,85 @@ StackError stack_pool_is_empty(const StackPool *stack, bool *out_empty);
  */
 StackError stack_pool_size(const StackPool *stack, size_t *out_size);
 
+/**
+ * @brief Opens a readiness descriptor for the stack.
+ *
+ * The returned eventfd becomes readable when the stack goes from empty
+ * to non-empty or its size falls below the watermark. After one signal
+ * the descriptor stays quiet until stack_pool_event_ack() is called, so
+ * a burst of operations causes one wakeup. Opening it again only
+ * changes the watermark and re-arms it. Available on Linux only.
+ *
+ * @param stack Pointer to the stack.
+ * @param watermark Size to signal when falling below, 0 to signal
+ * only on the empty to non-empty transition.
+ * @param out_fd Pointer to a variable in which the descriptor will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_fd pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The eventfd could not be created.
+ */
+StackError stack_pool_event_open(StackPool *stack, size_t watermark, int *out_fd);
+
+/**
+ * @brief Acknowledges a readiness signal and re-arms the descriptor.
+ *
+ * Transitions that happened while the descriptor was disarmed are not
+ * signaled again, so check the stack after the call.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: No readiness descriptor is open.
+ *          -STACK_UNKNOWN_ERROR: The eventfd could not be read.
+ */
+StackError stack_pool_event_ack(StackPool *stack);
+
+/**
+ * @brief Closes the readiness descriptor, also done by destroy.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_pool_event_close(StackPool *stack);
+
+/**
+ * @brief Gets the operation counters of the stack.
+ *
+ * Available when the library is built with STACK_ENABLE_STATS.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_stats Pointer to a variable in which the counters will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_stats pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_STATS.
+ */
+StackError stack_pool_stats(const StackPool *stack, StackStats *out_stats);
+
+/**
+ * @brief Gets the sampled latency of an operation of the stack.
+ *
+ * Available when the library is built with STACK_ENABLE_TRACE. Only
+ * operations that succeed are timed; all fields are zero until the
+ * first sample.
+ *
+ * @param stack Pointer to the stack.
+ * @param op Operation to report.
+ * @param out_latency Pointer to a variable in which the percentiles will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The operation is unknown.
+ *          -STACK_NULL_OUT: The out_latency pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_TRACE.
+ */
+StackError stack_pool_latency(const StackPool *stack, StackTraceOp op, StackLatency *out_latency);
+
 #endif // STACK_POOL_H
 
@@ -0,0 +1,137 @@
+/**
+ * @file stack_pool_blocking.h
+ * @brief Bounded blocking stack with a memory pool for multiple
+ * producers and consumers.
+ *
+ * A fixed StackPool guarded by a mutex. Besides the non-blocking push
+ * and pop, which fail with STACK_FULL and STACK_EMPTY, the wait
+ * variants park the calling thread on a condition variable until the
+ * stack has room or an element, or until the timeout expires. Waiters
+ * are counted, so an operation that nobody waits for costs only the
+ * uncontended lock and unlock.
+ */
+
+#ifndef STACK_POOL_BLOCKING_H
+#define STACK_POOL_BLOCKING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stack_errors.h>
+#include <stack_pool.h>
+
+// Timeout value that waits without a time limit.
+#define STACK_WAIT_FOREVER ((int64_t) -1)
+
+// Definition of the blocking stack
+typedef struct {
+    pthread_mutex_t lock;       // Guards the pool and the waiter counts
+    pthread_cond_t not_full;    // Signaled when a pop makes room
+    pthread_cond_t not_empty;   // Signaled when a push adds an element
+    size_t push_waiters;        // Threads waiting in push_wait
+    size_t pop_waiters;         // Threads waiting in pop_wait
+    StackPool *pool;            // Fixed pool holding the elements
+} StackPoolBlocking;
+
+/**
+ * @brief Creates a blocking stack with a memory pool.
+ *
+ * @param stack Pointer to a pointer of type StackPoolBlocking
+ * to bind to the new stack.
+ * @param capacity Number of elements the stack can hold.
+ * @param block_size The size of one element in bytes.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity parameter or the block_size parameter is zero.
+ *          -STACK_ALLOC_FAILED: Failed to allocate the required memory.
+ */
+StackError stack_pool_blocking_init(StackPoolBlocking **stack, size_t capacity, size_t block_size);
+
+/**
+ * @brief Destroys the stack and frees all allocated memory.
+ *
+ * Must not be called while other threads use or wait on the stack.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_pool_blocking_destroy(StackPoolBlocking *stack);
+
+/**
+ * @brief Pushes an element without waiting.
+ *
+ * @param stack Pointer to the stack.
+ * @param data Pointer to the data to push.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The data pointer is NULL.
+ *          -STACK_FULL: The stack is full.
+ */
+StackError stack_pool_blocking_push(StackPoolBlocking *stack, const void *data);
+
+/**
+ * @brief Pops an element without waiting.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_data Pointer to a variable into which
+ * the extracted value will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+StackError stack_pool_blocking_pop(StackPoolBlocking *stack, void *out_data);
+
+/**
+ * @brief Pushes an element, waiting while the stack is full.
+ *
+ * @param stack Pointer to the stack.
+ * @param data Pointer to the data to push.
+ * @param timeout_ns Maximum time to wait in nanoseconds,
+ * STACK_WAIT_FOREVER to wait without a limit, 0 not to wait at all.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The data pointer is NULL.
+ *          -STACK_FULL: The stack is full and timeout_ns is 0.
+ *          -STACK_TIMEOUT: The stack stayed full until the timeout.
+ */
+StackError stack_pool_blocking_push_wait(StackPoolBlocking *stack, const void *data,
+                                         int64_t timeout_ns);
+
+/**
+ * @brief Pops an element, waiting while the stack is empty.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_data Pointer to a variable into which
+ * the extracted value will be written.
+ * @param timeout_ns Maximum time to wait in nanoseconds,
+ * STACK_WAIT_FOREVER to wait without a limit, 0 not to wait at all.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty and timeout_ns is 0.
+ *          -STACK_TIMEOUT: The stack stayed empty until the timeout.
+ */
+StackError stack_pool_blocking_pop_wait(StackPoolBlocking *stack, void *out_data,
+                                        int64_t timeout_ns);
+
+/**
+ * @brief Gets the size of the stack.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_size Pointer to a variable in which the size will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_size pointer is NULL.
+ */
+StackError stack_pool_blocking_size(StackPoolBlocking *stack, size_t *out_size);
+
+#endif // STACK_POOL_BLOCKING_H
@@ -0,0 +1,202 @@
+/**
+ * @file stack_pool_combining.h
+ * @brief Thread-safe stack with a memory pool (flat combining).
+ *
+ * Threads do not lock the pool for each operation. A thread posts its
+ * request in a publication slot; the thread that takes the combiner
+ * lock applies all posted requests in one pass while the others wait
+ * for their slot to be served. Pushes and pops of one pass are first
+ * matched against each other and exchange their blocks directly; the
+ * rest fill or drain one contiguous run of the pool, a block per
+ * request since every block comes from or goes to its own thread, so
+ * the pool's cache lines stay with the combiner. Each request gets its
+ * own result, STACK_FULL and STACK_EMPTY included. The pool's counters,
+ * readiness descriptor and latency samples see each pass like a batch
+ * operation of the pool.
+ */
+
+#ifndef STACK_POOL_COMBINING_H
+#define STACK_POOL_COMBINING_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stack_errors.h>
+#include <stack_pool.h>
+
+// Maximum number of threads that can have a request posted at the same time.
+#define STACK_FC_MAX_SLOTS 128
+
+// Size of a cache line, used to keep hot fields apart.
+#ifndef STACK_CACHE_LINE
+#define STACK_CACHE_LINE 64
+#endif
+
+// Kind of a posted request
+typedef enum {
+    STACK_FC_NONE = 0,      // No request, or the request has been served
+    STACK_FC_PUSH,          // Push the block
+    STACK_FC_POP,           // Pop into the block
+} StFcOperation;
+
+// The structure represents a publication slot.
+typedef struct stack_fc_slot {
+    _Alignas(STACK_CACHE_LINE) atomic_int operation;   // Posted StFcOperation
+    atomic_bool active;     // The slot is held by a thread
+    void *block;            // Source of a push or destination of a pop
+    StackError result;      // Result written by the combiner
+} StFcSlot;
+
+// Definition of the flat-combining stack
+typedef struct {
+    _Alignas(STACK_CACHE_LINE) atomic_bool lock;   // Combiner lock
+    StackPool *pool;                    // Fixed pool, accessed by the combiner only
+    atomic_size_t slot_count;           // Slots ever taken, the combiner scans only these
+    StFcSlot slots[STACK_FC_MAX_SLOTS];
+} StackPoolCombining;
+
+/**
+ * @brief Creates a flat-combining stack with a memory pool.
+ *
+ * @param stack Pointer to a pointer of type StackPoolCombining
+ * to bind to the new stack.
+ * @param capacity Number of elements the stack can hold.
+ * @param block_size The size of one element in bytes.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity parameter or the block_size parameter is zero.
+ *          -STACK_ALLOC_FAILED: Failed to allocate the required memory.
+ */
+StackError stack_pool_combining_init(StackPoolCombining **stack, size_t capacity, size_t block_size);
+
+/**
+ * @brief Destroys the stack and frees all allocated memory.
+ *
+ * Must not be called while other threads use the stack.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_pool_combining_destroy(StackPoolCombining *stack);
+
+/**
+ * @brief Pushes an element onto the stack. Safe to call from any thread.
+ *
+ * @param stack Pointer to the stack.
+ * @param data Pointer to the data to push.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The data pointer is NULL.
+ *          -STACK_FULL: The stack is full.
+ */
+StackError stack_pool_combining_push(StackPoolCombining *stack, const void *data);
+
+/**
+ * @brief Pops an element from the stack. Safe to call from any thread.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_data Pointer to a variable into which
+ * the extracted value will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ */
+StackError stack_pool_combining_pop(StackPoolCombining *stack, void *out_data);
+
+/**
+ * @brief Gets the size of the stack.
+ *
+ * The value is exact only when no other thread is pushing or popping.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_size Pointer to a variable in which the size will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_size pointer is NULL.
+ */
+StackError stack_pool_combining_size(StackPoolCombining *stack, size_t *out_size);
+
+/**
+ * @brief Opens a readiness descriptor for the stack.
+ *
+ * Same as stack_pool_event_open(), taking the combiner lock so it is
+ * safe to call while other threads push and pop.
+ *
+ * @param stack Pointer to the stack.
+ * @param watermark Size to signal when falling below, 0 to signal
+ * only on the empty to non-empty transition.
+ * @param out_fd Pointer to a variable in which the descriptor will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_fd pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The eventfd could not be created.
+ */
+StackError stack_pool_combining_event_open(StackPoolCombining *stack, size_t watermark, int *out_fd);
+
+/**
+ * @brief Acknowledges a readiness signal and re-arms the descriptor.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: No readiness descriptor is open.
+ *          -STACK_UNKNOWN_ERROR: The eventfd could not be read.
+ */
+StackError stack_pool_combining_event_ack(StackPoolCombining *stack);
+
+/**
+ * @brief Closes the readiness descriptor, also done by destroy.
+ *
+ * @param stack Pointer to the stack.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_pool_combining_event_close(StackPoolCombining *stack);
+
+/**
+ * @brief Gets the operation counters of the stack.
+ *
+ * Available when the library is built with STACK_ENABLE_STATS. Requests
+ * matched within a pass count as a push and a pop.
+ *
+ * @param stack Pointer to the stack.
+ * @param out_stats Pointer to a variable in which the counters will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_stats pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_STATS.
+ */
+StackError stack_pool_combining_stats(const StackPoolCombining *stack, StackStats *out_stats);
+
+/**
+ * @brief Gets the sampled latency of the combining passes.
+ *
+ * Available when the library is built with STACK_ENABLE_TRACE. A pass
+ * is sampled as one operation, a push if it served any push and a pop
+ * otherwise.
+ *
+ * @param stack Pointer to the stack.
+ * @param op Operation to report.
+ * @param out_latency Pointer to a variable in which the percentiles will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The operation is unknown.
+ *          -STACK_NULL_OUT: The out_latency pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_TRACE.
+ */
+StackError stack_pool_combining_latency(const StackPoolCombining *stack, StackTraceOp op,
+                                        StackLatency *out_latency);
+
+#endif // STACK_POOL_COMBINING_H
@@ -0,0 +1,146 @@
+/**
+ * @file stack_pool_shared.h
+ * @brief Bounded stack with a memory pool shared between processes.
+ *
+ * The stack lives in one shared memory object: a header followed by
+ * the blocks. The header keeps sizes and an offset instead of the
+ * pool and top pointers of StackPool, so each process can map it at
+ * any address. Operations are serialized with a process-shared robust
+ * mutex. A push or pop changes the size only after its block copy, so
+ * if a process dies while holding the lock, the next process takes the
+ * lock over and finds the stack consistent.
+ */
+
+#ifndef STACK_POOL_SHARED_H
+#define STACK_POOL_SHARED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <stack_errors.h>
+#include <stack_pool.h>
+
+// Header at the start of the shared memory object. Only the magic is
+// accessed outside the lock.
+typedef struct {
+    _Atomic uint64_t magic;     // Marks an initialized object, published last
+    pthread_mutex_t lock;       // Process-shared robust mutex
+    uint64_t block_size;        // The size of one element in bytes
+    uint64_t capacity;          // Number of elements the stack can hold
+    uint64_t size;              // Number of stack elements
+    uint64_t data_offset;       // Offset of the first block from the header
+    uint64_t owner_deaths;      // Times the lock was recovered from a dead process
+} StSharedHeader;
+
+// Handle of a process on the shared stack
+typedef struct {
+    StSharedHeader *header;     // Start of the mapping
+    byte *blocks;               // First block in this process
+    size_t mapping_size;        // Length of the mapping in bytes
+    stack_block_copy copy_block;    // Copy kernel selected for block_size
+} StackPoolShared;
+
+/**
+ * @brief Creates a shared stack.
+ *
+ * With a name the stack is a POSIX shared memory object that other
+ * processes can attach to. Without one it is an anonymous shared
+ * mapping, inherited by processes forked afterwards.
+ *
+ * @param stack Pointer to a pointer of type StackPoolShared
+ * to bind to the new handle.
+ * @param name Name for shm_open() ("/name"), or NULL.
+ * @param capacity Number of elements the stack can hold.
+ * @param block_size The size of one element in bytes.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_INVALID_ARGS: The capacity parameter or the block_size parameter is zero.
+ *          -STACK_ALLOC_FAILED: The shared memory could not be created or mapped,
+ *          for example because the name exists.
+ */
+StackError stack_pool_shared_create(StackPoolShared **stack, const char *name,
+                                    size_t capacity, size_t block_size);
+
+/**
+ * @brief Attaches to a named shared stack created by another process.
+ *
+ * @param stack Pointer to a pointer of type StackPoolShared
+ * to bind to the new handle.
+ * @param name Name passed to stack_pool_shared_create().
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer or the name is NULL.
+ *          -STACK_INVALID_TYPE: The object is not an initialized shared stack.
+ *          -STACK_ALLOC_FAILED: The shared memory could not be opened or mapped.
+ */
+StackError stack_pool_shared_attach(StackPoolShared **stack, const char *name);
+
+/**
+ * @brief Unmaps the stack from this process and frees the handle.
+ *
+ * The stack itself stays until the name is unlinked and every process
+ * has detached.
+ *
+ * @param stack Pointer to the handle.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ */
+StackError stack_pool_shared_detach(StackPoolShared *stack);
+
+/**
+ * @brief Removes the name of a shared stack.
+ *
+ * @param name Name passed to stack_pool_shared_create().
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The name is NULL.
+ *          -STACK_INVALID_ARGS: No shared memory object has the name.
+ */
+StackError stack_pool_shared_unlink(const char *name);
+
+/**
+ * @brief Pushes an element onto the stack. Safe to call from any process.
+ *
+ * @param stack Pointer to the handle.
+ * @param data Pointer to the data to push.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_DATA: The data pointer is NULL.
+ *          -STACK_FULL: The stack is full.
+ *          -STACK_UNKNOWN_ERROR: The lock is not recoverable.
+ */
+StackError stack_pool_shared_push(StackPoolShared *stack, const void *data);
+
+/**
+ * @brief Pops an element from the stack. Safe to call from any process.
+ *
+ * @param stack Pointer to the handle.
+ * @param out_data Pointer to a variable into which
+ * the extracted value will be written.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_data pointer is NULL.
+ *          -STACK_EMPTY: The stack is empty.
+ *          -STACK_UNKNOWN_ERROR: The lock is not recoverable.
+ */
+StackError stack_pool_shared_pop(StackPoolShared *stack, void *out_data);
+
+/**
+ * @brief Gets the size of the stack.
+ *
+ * @param stack Pointer to the handle.
+ * @param out_size Pointer to a variable in which the size will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The stack pointer is NULL.
+ *          -STACK_NULL_OUT: The out_size pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The lock is not recoverable.
+ */
+StackError stack_pool_shared_size(StackPoolShared *stack, size_t *out_size);
+
+#endif // STACK_POOL_SHARED_H
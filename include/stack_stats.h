@@ -0,0 +1,118 @@
+/**
+ * @file stack_stats.h
+ * @brief Optional operation counters shared by StackPool and StackDyn.
+ *
+ * The counters are compiled in only when STACK_ENABLE_STATS is defined
+ * in stack_config.h (the CMake option of the same name). Without it the stacks have no
+ * counter fields, the counting macros expand to nothing, and the stats
+ * accessors and stack_stats_dump() return STACK_UNKNOWN_ERROR.
+ *
+ * A counter has one writer, the thread operating the stack, and is
+ * updated with relaxed atomic loads and stores. That is as cheap as a
+ * plain increment, and another thread may read the counters or dump all
+ * live stacks at any time.
+ */
+
+#ifndef STACK_STATS_H
+#define STACK_STATS_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stack_config.h>
+#include <stack_errors.h>
+
+#ifdef STACK_ENABLE_STATS
+#include <stdatomic.h>
+#endif
+
+// Output format of stack_stats_dump()
+typedef enum {
+    STACK_STATS_TEXT = 0,   // One line of key=value pairs per stack
+    STACK_STATS_JSON,       // An array with one object per stack
+} StackStatsFormat;
+
+// Snapshot of the counters of one stack
+typedef struct {
+    size_t pushes;              // Elements pushed
+    size_t pops;                // Elements popped or dropped
+    size_t high_water;          // Largest number of elements held
+    size_t full_rejections;     // Pushes refused with STACK_FULL
+    size_t empty_rejections;    // Pops refused with STACK_EMPTY
+    size_t bytes_copied;        // Block bytes copied in and out (StackPool)
+    size_t allocations;         // Memory allocations made by the stack
+} StackStats;
+
+#ifdef STACK_ENABLE_STATS
+
+// Kind of stack holding the counters
+typedef enum {
+    STACK_STATS_POOL = 0,
+    STACK_STATS_DYN,
+} StStatsKind;
+
+// Counters embedded in a stack, linked into the registry of live stacks
+typedef struct stack_counters {
+    atomic_size_t pushes;
+    atomic_size_t pops;
+    atomic_size_t high_water;
+    atomic_size_t full_rejections;
+    atomic_size_t empty_rejections;
+    atomic_size_t bytes_copied;
+    atomic_size_t allocations;
+    StStatsKind kind;
+    const void *owner;              // Stack holding the counters, its id in dumps
+    struct stack_counters *prev;    // Registry links
+    struct stack_counters *next;
+} StStackCounters;
+
+static inline void stack_counter_add(atomic_size_t *counter, size_t value)
+{
+    size_t current = atomic_load_explicit(counter, memory_order_relaxed);
+    atomic_store_explicit(counter, current + value, memory_order_relaxed);
+}
+
+static inline void stack_counter_max(atomic_size_t *counter, size_t value)
+{
+    if (value > atomic_load_explicit(counter, memory_order_relaxed))
+        atomic_store_explicit(counter, value, memory_order_relaxed);
+}
+
+#define STACK_STAT_ADD(counters, field, value) stack_counter_add(&(counters).field, (value))
+#define STACK_STAT_MAX(counters, field, value) stack_counter_max(&(counters).field, (value))
+
+// Zeroes the counters and adds them to the registry of live stacks.
+void stack_stats_register(StStackCounters *counters, StStatsKind kind, const void *owner);
+
+// Removes the counters from the registry.
+void stack_stats_unregister(StStackCounters *counters);
+
+// Copies the counters into a snapshot.
+void stack_stats_read(const StStackCounters *counters, StackStats *out_stats);
+
+#else
+
+#define STACK_STAT_ADD(counters, field, value) ((void) 0)
+#define STACK_STAT_MAX(counters, field, value) ((void) 0)
+
+#endif // STACK_ENABLE_STATS
+
+/**
+ * @brief Writes the counters of all live stacks.
+ *
+ * Each stack is identified by its kind ("pool" or "dyn") and address.
+ * Safe to call from any thread. The counters are copied out under the
+ * registry lock and written after it is released, so a slow stream does
+ * not hold up stacks being created or destroyed.
+ *
+ * @param out Stream to write to.
+ * @param format Output format.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_PTR: The out pointer is NULL.
+ *          -STACK_INVALID_ARGS: The format is unknown.
+ *          -STACK_ALLOC_FAILED: No memory to copy the counters.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_STATS.
+ */
+StackError stack_stats_dump(FILE *out, StackStatsFormat format);
+
+#endif // STACK_STATS_H
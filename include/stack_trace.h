@@ -0,0 +1,149 @@
+/**
+ * @file stack_trace.h
+ * @brief Sampling latency tracer shared by StackPool and StackDyn.
+ *
+ * The tracer is compiled in only when STACK_ENABLE_TRACE is defined in
+ * stack_config.h (the CMake option of the same name). Every stack then
+ * counts its push, pop and clear operations down and times one in
+ * stack_trace_set_rate() operations with the monotonic clock. The durations go into a
+ * log-linear histogram per operation: eight buckets per power of two,
+ * so a reported latency is at most 12.5% above the measured one.
+ *
+ * The rate is zero by default, which samples nothing. While it is zero a
+ * stack rereads the rate every STACK_TRACE_RECHECK operations, so a new
+ * rate is picked up within that many operations. The histograms of a
+ * stack are allocated when it takes its first sample.
+ *
+ * Without STACK_ENABLE_TRACE the stacks have no tracer fields, the
+ * tracing macros expand to nothing and the functions return
+ * STACK_UNKNOWN_ERROR.
+ */
+
+#ifndef STACK_TRACE_H
+#define STACK_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stack_config.h>
+#include <stack_errors.h>
+
+#ifdef STACK_ENABLE_TRACE
+#include <stdatomic.h>
+#endif
+
+// Traced operations
+typedef enum {
+    STACK_TRACE_PUSH = 0,
+    STACK_TRACE_POP,
+    STACK_TRACE_CLEAR,
+    STACK_TRACE_OPS,    // Number of traced operations
+} StackTraceOp;
+
+// Latency percentiles of one operation, in nanoseconds
+typedef struct {
+    size_t samples;     // Operations timed
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+} StackLatency;
+
+#ifdef STACK_ENABLE_TRACE
+
+// Operations between two reads of a zero rate
+#define STACK_TRACE_RECHECK 1024
+
+// Sub-buckets per power of two, as a number of bits
+#define STACK_TRACE_SUB_BITS 3
+#define STACK_TRACE_BUCKETS ((64 - STACK_TRACE_SUB_BITS + 1) << STACK_TRACE_SUB_BITS)
+
+// Latency histogram of one operation
+typedef struct {
+    atomic_size_t counts[STACK_TRACE_BUCKETS];
+} StTraceHistogram;
+
+// Tracer state embedded in a stack
+typedef struct {
+    size_t countdown;                       // Operations until the next sample
+    _Atomic(StTraceHistogram *) histograms; // STACK_TRACE_OPS histograms, NULL until a sample
+} StStackTrace;
+
+extern atomic_size_t stack_trace_rate;
+
+// Returns the time of the monotonic clock in nanoseconds.
+uint64_t stack_trace_now(void);
+
+// Adds the duration of an operation started at start to its histogram.
+void stack_trace_record(StStackTrace *trace, StackTraceOp op, uint64_t start);
+
+// Frees the histograms.
+void stack_trace_close(StStackTrace *trace);
+
+// Reads the percentiles of an operation.
+void stack_trace_read(const StStackTrace *trace, StackTraceOp op, StackLatency *out_latency);
+
+// Counts an operation down, returns true if it is not sampled.
+static inline bool stack_trace_skip(StStackTrace *trace)
+{
+    if (trace->countdown > 1)
+    {
+        --trace->countdown;
+        return true;
+    }
+    return false;
+}
+
+// Returns the start time of a sampled operation, zero if it is not sampled.
+static inline uint64_t stack_trace_begin(StStackTrace *trace)
+{
+    if (stack_trace_skip(trace))
+        return 0;
+
+    size_t rate = atomic_load_explicit(&stack_trace_rate, memory_order_relaxed);
+    trace->countdown = rate ? rate : STACK_TRACE_RECHECK;
+    return rate ? stack_trace_now() : 0;
+}
+
+static inline void stack_trace_end(StStackTrace *trace, StackTraceOp op, uint64_t start)
+{
+    if (start)
+        stack_trace_record(trace, op, start);
+}
+
+#define STACK_TRACE_BEGIN(trace) uint64_t trace_start = stack_trace_begin(&(trace))
+#define STACK_TRACE_END(trace, op) stack_trace_end(&(trace), (op), trace_start)
+#define STACK_TRACE_SKIP(trace) stack_trace_skip(&(trace))
+
+#else
+
+#define STACK_TRACE_BEGIN(trace) ((void) 0)
+#define STACK_TRACE_END(trace, op) ((void) 0)
+#define STACK_TRACE_SKIP(trace) true
+
+#endif // STACK_ENABLE_TRACE
+
+/**
+ * @brief Sets how often stack operations are timed.
+ *
+ * Takes effect for each stack when its current countdown runs out.
+ *
+ * @param rate One operation in rate is timed, zero stops sampling.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_TRACE.
+ */
+StackError stack_trace_set_rate(size_t rate);
+
+/**
+ * @brief Gets the current sampling rate.
+ *
+ * @param out_rate Pointer to a variable in which the rate will be saved.
+ * @return StackError:
+ *          -STACK_OK: The operation was successful.
+ *          -STACK_NULL_OUT: The out_rate pointer is NULL.
+ *          -STACK_UNKNOWN_ERROR: The library is built without STACK_ENABLE_TRACE.
+ */
+StackError stack_trace_get_rate(size_t *out_rate);
+
+#endif // STACK_TRACE_H
@@ -0,0 +1,186 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stack_alloc.h>
+
+// Alignment of every arena allocation.
+#define STACK_ARENA_ALIGN _Alignof(max_align_t)
+
+// Distance from a block header to its first allocation.
+#define STACK_ARENA_HEADER \
+    ((sizeof(StArenaBlock) + STACK_ARENA_ALIGN - 1) / STACK_ARENA_ALIGN * STACK_ARENA_ALIGN)
+
+static void *stack_malloc_alloc(void *ctx, size_t size)
+{
+    (void) ctx;
+    return malloc(size);
+}
+
+static void *stack_malloc_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    (void) ctx;
+    (void) old_size;
+    return realloc(ptr, new_size);
+}
+
+static void stack_malloc_free(void *ctx, void *ptr, size_t size)
+{
+    (void) ctx;
+    (void) size;
+    free(ptr);
+}
+
+const StackAllocator stack_allocator_malloc = {
+    stack_malloc_alloc,
+    stack_malloc_realloc,
+    stack_malloc_free,
+    NULL,
+};
+
+static unsigned char *stack_arena_data(StArenaBlock *block)
+{
+    return (unsigned char *) block + STACK_ARENA_HEADER;
+}
+
+static void *stack_arena_alloc(void *ctx, size_t size)
+{
+    StackArena *arena = ctx;
+    size_t offset = (arena->used + STACK_ARENA_ALIGN - 1) / STACK_ARENA_ALIGN * STACK_ARENA_ALIGN;
+
+    if (!arena->block || offset > arena->block->size || size > arena->block->size - offset)
+    {
+        size_t block_size = size > arena->block_size ? size : arena->block_size;
+        if (block_size > SIZE_MAX - STACK_ARENA_HEADER)
+            return NULL;
+
+        StArenaBlock *block = malloc(STACK_ARENA_HEADER + block_size);
+        if (!block)
+            return NULL;
+
+        block->prev = arena->block;
+        block->size = block_size;
+        arena->block = block;
+        offset = 0;
+    }
+
+    arena->last = stack_arena_data(arena->block) + offset;
+    arena->used = offset + size;
+    return arena->last;
+}
+
+static void *stack_arena_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    StackArena *arena = ctx;
+
+    if (ptr && ptr == arena->last)
+    {
+        size_t offset = (size_t) ((unsigned char *) ptr - stack_arena_data(arena->block));
+        if (new_size <= arena->block->size - offset)
+        {
+            arena->used = offset + new_size;
+            return ptr;
+        }
+    }
+
+    void *moved = stack_arena_alloc(ctx, new_size);
+    if (moved && ptr)
+        memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    return moved;
+}
+
+static void stack_arena_free(void *ctx, void *ptr, size_t size)
+{
+    // Memory goes back with the whole arena
+    (void) ctx;
+    (void) ptr;
+    (void) size;
+}
+
+StackError stack_arena_init(StackArena *arena, size_t block_size)
+{
+    if (!arena)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (block_size == 0)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    arena->block = NULL;
+    arena->used = 0;
+    arena->block_size = block_size;
+    arena->last = NULL;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_arena_reset(StackArena *arena)
+{
+    if (!arena)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    while (arena->block && arena->block->prev)
+    {
+        StArenaBlock *prev = arena->block->prev;
+        free(arena->block);
+        arena->block = prev;
+    }
+    arena->used = 0;
+    arena->last = NULL;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_arena_destroy(StackArena *arena)
+{
+    if (!arena)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    while (arena->block)
+    {
+        StArenaBlock *prev = arena->block->prev;
+        free(arena->block);
+        arena->block = prev;
+    }
+    arena->used = 0;
+    arena->last = NULL;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_arena_allocator(StackArena *arena, StackAllocator *out_allocator)
+{
+    if (!arena)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_allocator)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    out_allocator->alloc = stack_arena_alloc;
+    out_allocator->realloc = stack_arena_realloc;
+    out_allocator->free = stack_arena_free;
+    out_allocator->ctx = arena;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
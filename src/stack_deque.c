@@ -0,0 +1,316 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stack_deque.h>
+
+// Blocks up to this size are staged on the stack of a thief, larger ones on the heap.
+#define STACK_DEQUE_STAGING 256
+
+// Returns the address of the block with the given index.
+static inline byte *stack_deque_block(const StackDeque *deque, StDequeBuffer *buffer, int64_t index)
+{
+    return buffer->blocks + ((size_t) index & (buffer->capacity - 1)) * deque->stride;
+}
+
+// Writes a block into a slot that a thief may be reading at the same time.
+static void stack_deque_store(byte *slot, const byte *data, size_t size)
+{
+    _Atomic uintptr_t *words = (_Atomic uintptr_t *) slot;
+    size_t count = size / sizeof(uintptr_t);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uintptr_t word;
+        memcpy(&word, data + i * sizeof(uintptr_t), sizeof(word));
+        atomic_store_explicit(&words[i], word, memory_order_relaxed);
+    }
+
+    _Atomic byte *tail = (_Atomic byte *) (words + count);
+    for (size_t i = count * sizeof(uintptr_t); i < size; ++i)
+        atomic_store_explicit(&tail[i - count * sizeof(uintptr_t)], data[i], memory_order_relaxed);
+}
+
+// Reads a block from a slot that the owner may be writing at the same time.
+static void stack_deque_load(byte *out, byte *slot, size_t size)
+{
+    _Atomic uintptr_t *words = (_Atomic uintptr_t *) slot;
+    size_t count = size / sizeof(uintptr_t);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uintptr_t word = atomic_load_explicit(&words[i], memory_order_relaxed);
+        memcpy(out + i * sizeof(uintptr_t), &word, sizeof(word));
+    }
+
+    _Atomic byte *tail = (_Atomic byte *) (words + count);
+    for (size_t i = count * sizeof(uintptr_t); i < size; ++i)
+        out[i] = atomic_load_explicit(&tail[i - count * sizeof(uintptr_t)], memory_order_relaxed);
+}
+
+// Allocates a buffer of capacity blocks.
+static StDequeBuffer *stack_deque_buffer_alloc(size_t capacity, size_t stride)
+{
+    if (capacity > (SIZE_MAX - sizeof(StDequeBuffer)) / stride)
+        return NULL;
+
+    StDequeBuffer *buffer = malloc(sizeof(StDequeBuffer) + capacity * stride);
+    if (!buffer)
+        return NULL;
+
+    buffer->capacity = capacity;
+    buffer->prev = NULL;
+    return buffer;
+}
+
+// Replaces a full buffer with one of double capacity holding the blocks from top to bottom.
+static StDequeBuffer *stack_deque_grow(StackDeque *deque, StDequeBuffer *buffer,
+                                       int64_t top, int64_t bottom)
+{
+    if (buffer->capacity > SIZE_MAX / 2)
+        return NULL;
+
+    StDequeBuffer *new_buffer = stack_deque_buffer_alloc(buffer->capacity * 2, deque->stride);
+    if (!new_buffer)
+        return NULL;
+
+    for (int64_t i = top; i < bottom; ++i)
+        deque->copy_block(stack_deque_block(deque, new_buffer, i),
+                          stack_deque_block(deque, buffer, i), deque->block_size);
+
+    new_buffer->prev = buffer;
+    atomic_store_explicit(&deque->buffer, new_buffer, memory_order_release);
+    return new_buffer;
+}
+
+StackError stack_deque_init(StackDeque **deque, size_t capacity, size_t block_size)
+{
+    if (!deque)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((capacity == 0) || (block_size == 0) || (capacity > SIZE_MAX / 2) ||
+        (block_size > SIZE_MAX - sizeof(uintptr_t)))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    size_t rounded = 1;
+    while (rounded < capacity)
+        rounded *= 2;
+
+    StackDeque *new_deque = aligned_alloc(STACK_CACHE_LINE, sizeof(StackDeque));
+    if (!new_deque)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    size_t stride = (block_size + sizeof(uintptr_t) - 1) / sizeof(uintptr_t) * sizeof(uintptr_t);
+    StDequeBuffer *buffer = stack_deque_buffer_alloc(rounded, stride);
+    if (!buffer)
+    {
+        free(new_deque);
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    atomic_init(&new_deque->top, 0);
+    atomic_init(&new_deque->bottom, 0);
+    atomic_init(&new_deque->buffer, buffer);
+    new_deque->block_size = block_size;
+    new_deque->stride = stride;
+    new_deque->copy_block = stack_pool_copy_kernel(block_size);
+    *deque = new_deque;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_deque_destroy(StackDeque *deque)
+{
+    if (!deque)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    StDequeBuffer *buffer = atomic_load(&deque->buffer);
+    while (buffer)
+    {
+        StDequeBuffer *prev = buffer->prev;
+        free(buffer);
+        buffer = prev;
+    }
+    free(deque);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_deque_push(StackDeque *deque, const void *data)
+{
+    if (!deque)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!data)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    StDequeBuffer *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+
+    if (bottom - top > (int64_t) buffer->capacity - 1)
+    {
+        buffer = stack_deque_grow(deque, buffer, top, bottom);
+        if (!buffer)
+        {
+            STACK_SET_ERROR(STACK_ALLOC_FAILED);
+            return STACK_ALLOC_FAILED;
+        }
+    }
+
+    stack_deque_store(stack_deque_block(deque, buffer, bottom), data, deque->block_size);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_deque_pop(StackDeque *deque, void *out_data)
+{
+    if (!deque)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    StDequeBuffer *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        STACK_SET_ERROR(STACK_EMPTY);
+        return STACK_EMPTY;
+    }
+
+    if (top == bottom)
+    {
+        // The last element, race the thieves for it
+        bool won = atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                           memory_order_seq_cst,
+                                                           memory_order_relaxed);
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        if (!won)
+        {
+            STACK_SET_ERROR(STACK_EMPTY);
+            return STACK_EMPTY;
+        }
+    }
+
+    // Only the owner writes the slot, so it can be copied after the race
+    deque->copy_block(out_data, stack_deque_block(deque, buffer, bottom), deque->block_size);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_deque_steal(StackDeque *deque, void *out_data)
+{
+    if (!deque)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    // The slot is copied before the CAS and may be overwritten once it is
+    // lost, so out_data is written only when the element is ours
+    byte local[STACK_DEQUE_STAGING];
+    byte *staging = local;
+    if (deque->block_size > sizeof(local))
+    {
+        staging = malloc(deque->block_size);
+        if (!staging)
+        {
+            STACK_SET_ERROR(STACK_ALLOC_FAILED);
+            return STACK_ALLOC_FAILED;
+        }
+    }
+
+    StackError err = STACK_EMPTY;
+    for (;;)
+    {
+        int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+        if (top >= bottom)
+            break;
+
+        StDequeBuffer *buffer = atomic_load_explicit(&deque->buffer, memory_order_acquire);
+        stack_deque_load(staging, stack_deque_block(deque, buffer, top), deque->block_size);
+
+        if (atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                    memory_order_seq_cst,
+                                                    memory_order_relaxed))
+        {
+            deque->copy_block(out_data, staging, deque->block_size);
+            err = STACK_OK;
+            break;
+        }
+    }
+
+    if (staging != local)
+        free(staging);
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_deque_size(const StackDeque *deque, size_t *out_size)
+{
+    if (!deque)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_size)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    *out_size = bottom > top ? (size_t) (bottom - top) : 0;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
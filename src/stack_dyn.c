@@ -1,36 +1,200 @@
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <stack_dyn.h>
 
+// Alignment of the payload of a sized node.
+#define STACK_DYN_ALIGN _Alignof(max_align_t)
+#define STACK_DYN_ROUND(bytes) (((bytes) + STACK_DYN_ALIGN - 1) / STACK_DYN_ALIGN * STACK_DYN_ALIGN)
+
+// Offsets of the first node of a sized slab and of the payload of a sized node.
+#define STACK_DYN_SIZED_SLAB_HEADER STACK_DYN_ROUND(sizeof(StSlab *))
+#define STACK_DYN_SIZED_NODE_HEADER STACK_DYN_ROUND(sizeof(StNode))
+
+// Size of one slab, sized nodes are laid out node_size apart.
+static size_t stack_dyn_slab_size(const StackDyn *stack)
+{
+    if (!stack->elem_size)
+        return sizeof(StSlab);
+    return STACK_DYN_SIZED_SLAB_HEADER + STACK_DYN_SLAB_NODES * stack->node_size;
+}
+
+// Takes a node from the free list or carves it out of the newest slab.
+static StNode *stack_dyn_node_alloc(StackDyn *stack)
+{
+    StNode *node = stack->free_nodes;
+    if (node)
+    {
+        stack->free_nodes = node->next;
+        return node;
+    }
+
+    if (!stack->slabs || stack->slab_used == STACK_DYN_SLAB_NODES)
+    {
+        StSlab *slab = stack->allocator.alloc(stack->allocator.ctx, stack_dyn_slab_size(stack));
+        if (!slab)
+            return NULL;
+        STACK_STAT_ADD(stack->stats, allocations, 1);
+
+        slab->next = stack->slabs;
+        stack->slabs = slab;
+        stack->slab_used = 0;
+    }
+
+    if (!stack->elem_size)
+        return &stack->slabs->nodes[stack->slab_used++];
+
+    // The payload of a sized node stays at the same place, it is pointed to once
+    node = (StNode *) ((unsigned char *) stack->slabs + STACK_DYN_SIZED_SLAB_HEADER +
+                       stack->slab_used++ * stack->node_size);
+    node->data = (unsigned char *) node + STACK_DYN_SIZED_NODE_HEADER;
+    return node;
+}
+
+// Returns a node to the free list.
+static void stack_dyn_node_free(StackDyn *stack, StNode *node)
+{
+    node->next = stack->free_nodes;
+    stack->free_nodes = node;
+}
+
+// Makes room for one more element pointer, starting a new chunk when the top one is full.
+static StackError stack_dyn_chunk_reserve(StackDyn *stack)
+{
+    if (!stack->chunk || stack->chunk_used == STACK_DYN_CHUNK_ITEMS)
+    {
+        StChunk *chunk = stack->spare_chunk;
+        if (chunk)
+            stack->spare_chunk = NULL;
+        else
+        {
+            chunk = stack->allocator.alloc(stack->allocator.ctx, sizeof(StChunk));
+            if (!chunk)
+                return STACK_ALLOC_FAILED;
+            STACK_STAT_ADD(stack->stats, allocations, 1);
+        }
+
+        chunk->prev = stack->chunk;
+        stack->chunk = chunk;
+        stack->chunk_used = 0;
+    }
+
+    return STACK_OK;
+}
+
+// Stores an element pointer in the top chunk.
+static StackError stack_dyn_chunk_push(StackDyn *stack, void *item)
+{
+    if (stack_dyn_chunk_reserve(stack) != STACK_OK)
+        return STACK_ALLOC_FAILED;
+
+    stack->chunk->items[stack->chunk_used++] = item;
+    return STACK_OK;
+}
+
+// Drops the emptied top chunk, it is kept as a spare.
+static void stack_dyn_chunk_release(StackDyn *stack)
+{
+    StChunk *chunk = stack->chunk;
+
+    stack->chunk = chunk->prev;
+    stack->chunk_used = stack->chunk ? STACK_DYN_CHUNK_ITEMS : 0;
+    if (stack->spare_chunk)
+        stack->allocator.free(stack->allocator.ctx, stack->spare_chunk, sizeof(StChunk));
+    stack->spare_chunk = chunk;
+}
+
+// Removes the top element pointer.
+static void *stack_dyn_chunk_pop(StackDyn *stack)
+{
+    void *item = stack->chunk->items[--stack->chunk_used];
+
+    if (stack->chunk_used == 0)
+        stack_dyn_chunk_release(stack);
+
+    return item;
+}
+
 StackError stack_dyn_init(StackDyn **stack, stack_copy_data copy, stack_destroy_data destroy)
 {
-    if (!stack)
+    return stack_dyn_init_allocator(stack, copy, destroy, false, &stack_allocator_malloc);
+}
+
+StackError stack_dyn_init_allocator(StackDyn **stack, stack_copy_data copy,
+                                    stack_destroy_data destroy, bool chunked,
+                                    const StackAllocator *allocator)
+{
+    if (!stack || !allocator)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
-    if ((!copy && destroy) || (copy && !destroy))
+    if ((!copy && destroy) || (copy && !destroy) ||
+        !allocator->alloc || !allocator->realloc || !allocator->free)
     {
-        stack_last_error = STACK_INVALID_ARGS;
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
         return STACK_INVALID_ARGS;
     }
 
-    StackDyn *new_stack = calloc(1, sizeof(StackDyn));
+    StackDyn *new_stack = allocator->alloc(allocator->ctx, sizeof(StackDyn));
     if (!new_stack)
     {
-        stack_last_error = STACK_ALLOC_FAILED;
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
         return STACK_ALLOC_FAILED;
     }
+    memset(new_stack, 0, sizeof(StackDyn));
 
     new_stack->top = NULL;
     new_stack->size = 0;
     new_stack->copy = copy;
     new_stack->destroy = destroy;
+    new_stack->free_nodes = NULL;
+    new_stack->slabs = NULL;
+    new_stack->slab_used = 0;
+    new_stack->chunked = chunked;
+    new_stack->chunk = NULL;
+    new_stack->chunk_used = 0;
+    new_stack->spare_chunk = NULL;
+    stack_event_init(&new_stack->event);
+    new_stack->allocator = *allocator;
+#ifdef STACK_ENABLE_STATS
+    stack_stats_register(&new_stack->stats, STACK_STATS_DYN, new_stack);
+    STACK_STAT_ADD(new_stack->stats, allocations, 1);
+#endif
     *stack = new_stack;
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_init_chunked(StackDyn **stack, stack_copy_data copy, stack_destroy_data destroy)
+{
+    return stack_dyn_init_allocator(stack, copy, destroy, true, &stack_allocator_malloc);
+}
+
+StackError stack_dyn_init_sized(StackDyn **stack, size_t elem_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((elem_size == 0) || (elem_size > SIZE_MAX / (2 * STACK_DYN_SLAB_NODES)))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    StackError err = stack_dyn_init(stack, NULL, NULL);
+    if (err != STACK_OK)
+        return err;
+
+    (*stack)->elem_size = elem_size;
+    (*stack)->node_size = STACK_DYN_ROUND(STACK_DYN_SIZED_NODE_HEADER + elem_size);
     return STACK_OK;
 }
 
@@ -38,20 +202,51 @@ StackError stack_dyn_push(StackDyn *stack, const void *data)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
-    if (stack->copy && !data)
+    if ((stack->copy || stack->elem_size) && !data)
     {
-        stack_last_error = STACK_NULL_DATA;
+        STACK_SET_ERROR(STACK_NULL_DATA);
         return STACK_NULL_DATA;
     }
 
-    StNode *new_node = calloc(1, sizeof(StNode));
+    STACK_TRACE_BEGIN(stack->trace);
+    if (stack->chunked)
+    {
+        void *item = (void *) data;
+        if (stack->copy)
+        {
+            item = stack->copy(data);
+            if (!item)
+            {
+                STACK_SET_ERROR(STACK_DATA_COPY_FAILED);
+                return STACK_DATA_COPY_FAILED;
+            }
+        }
+
+        if (stack_dyn_chunk_push(stack, item) != STACK_OK)
+        {
+            if (stack->destroy)
+                stack->destroy(item);
+            STACK_SET_ERROR(STACK_ALLOC_FAILED);
+            return STACK_ALLOC_FAILED;
+        }
+
+        ++stack->size;
+        stack_event_update(&stack->event, stack->size - 1, stack->size);
+        STACK_STAT_ADD(stack->stats, pushes, 1);
+        STACK_STAT_MAX(stack->stats, high_water, stack->size);
+        STACK_TRACE_END(stack->trace, STACK_TRACE_PUSH);
+        STACK_SET_ERROR(STACK_OK);
+        return STACK_OK;
+    }
+
+    StNode *new_node = stack_dyn_node_alloc(stack);
     if (!new_node)
     {
-        stack_last_error = STACK_ALLOC_FAILED;
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
         return STACK_ALLOC_FAILED;
     }
 
@@ -60,50 +255,306 @@ StackError stack_dyn_push(StackDyn *stack, const void *data)
         new_node->data = stack->copy(data);
         if (!new_node->data)
         {
-            free(new_node);
-            stack_last_error = STACK_DATA_COPY_FAILED;
+            stack_dyn_node_free(stack, new_node);
+            STACK_SET_ERROR(STACK_DATA_COPY_FAILED);
             return STACK_DATA_COPY_FAILED;
         }
     }
+    else if (stack->elem_size)
+        memcpy(new_node->data, data, stack->elem_size);
     else
         new_node->data = (void *) data;
 
     new_node->next = stack->top;
     stack->top = new_node;
     ++stack->size;
+    stack_event_update(&stack->event, stack->size - 1, stack->size);
+    STACK_STAT_ADD(stack->stats, pushes, 1);
+    STACK_STAT_MAX(stack->stats, high_water, stack->size);
+    STACK_STAT_ADD(stack->stats, bytes_copied, stack->elem_size);
+    STACK_TRACE_END(stack->trace, STACK_TRACE_PUSH);
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
+StackError stack_dyn_push_n(StackDyn *stack, void *const *data, size_t count, size_t *out_pushed)
+{
+    if (out_pushed)
+        *out_pushed = 0;
+
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!data && count)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    size_t pushed = 0;
+    StackError err = STACK_OK;
+
+    if (stack->chunked && !stack->copy)
+    {
+        // Pointers are copied into the chunks run by run
+        while (pushed < count)
+        {
+            err = stack_dyn_chunk_reserve(stack);
+            if (err != STACK_OK)
+                break;
+
+            size_t run = STACK_DYN_CHUNK_ITEMS - stack->chunk_used;
+            if (run > count - pushed)
+                run = count - pushed;
+
+            memcpy(&stack->chunk->items[stack->chunk_used], &data[pushed], run * sizeof(void *));
+            stack->chunk_used += run;
+            pushed += run;
+        }
+    }
+    else if (stack->chunked)
+    {
+        for (; pushed < count; ++pushed)
+        {
+            if (!data[pushed])
+            {
+                err = STACK_NULL_DATA;
+                break;
+            }
+
+            void *item = stack->copy(data[pushed]);
+            if (!item)
+            {
+                err = STACK_DATA_COPY_FAILED;
+                break;
+            }
+
+            if (stack_dyn_chunk_push(stack, item) != STACK_OK)
+            {
+                stack->destroy(item);
+                err = STACK_ALLOC_FAILED;
+                break;
+            }
+        }
+    }
+    else
+    {
+        // The run is linked below the old top and attached at once
+        StNode *top = stack->top;
+
+        for (; pushed < count; ++pushed)
+        {
+            if ((stack->copy || stack->elem_size) && !data[pushed])
+            {
+                err = STACK_NULL_DATA;
+                break;
+            }
+
+            StNode *node = stack_dyn_node_alloc(stack);
+            if (!node)
+            {
+                err = STACK_ALLOC_FAILED;
+                break;
+            }
+
+            if (stack->copy)
+            {
+                node->data = stack->copy(data[pushed]);
+                if (!node->data)
+                {
+                    stack_dyn_node_free(stack, node);
+                    err = STACK_DATA_COPY_FAILED;
+                    break;
+                }
+            }
+            else if (stack->elem_size)
+                memcpy(node->data, data[pushed], stack->elem_size);
+            else
+                node->data = data[pushed];
+
+            node->next = top;
+            top = node;
+        }
+
+        stack->top = top;
+    }
+
+    stack->size += pushed;
+    stack_event_update(&stack->event, stack->size - pushed, stack->size);
+    STACK_STAT_ADD(stack->stats, pushes, pushed);
+    STACK_STAT_MAX(stack->stats, high_water, stack->size);
+    STACK_STAT_ADD(stack->stats, bytes_copied, pushed * stack->elem_size);
+    if (out_pushed)
+        *out_pushed = pushed;
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_dyn_pop_n(StackDyn *stack, void **out_data, size_t count, size_t *out_popped)
+{
+    if (out_popped)
+        *out_popped = 0;
+
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data && count)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    // The nodes of a sized stack are recycled, their payload cannot be handed out
+    if (stack->elem_size)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    size_t popped = count < stack->size ? count : stack->size;
+
+    // Pointers keep their stack order, the former top ends up last
+    if (stack->chunked)
+    {
+        size_t remaining = popped;
+
+        while (remaining)
+        {
+            size_t run = remaining < stack->chunk_used ? remaining : stack->chunk_used;
+            remaining -= run;
+            stack->chunk_used -= run;
+
+            memcpy(&out_data[remaining], &stack->chunk->items[stack->chunk_used], run * sizeof(void *));
+            if (stack->chunk_used == 0)
+                stack_dyn_chunk_release(stack);
+        }
+    }
+    else if (popped)
+    {
+        StNode *node = stack->top;
+        StNode *last = NULL;
+
+        for (size_t i = popped; i > 0; --i)
+        {
+            out_data[i - 1] = node->data;
+            last = node;
+            node = node->next;
+        }
+
+        // The whole run goes to the free list at once
+        last->next = stack->free_nodes;
+        stack->free_nodes = stack->top;
+        stack->top = node;
+    }
+
+    stack->size -= popped;
+    stack_event_update(&stack->event, stack->size + popped, stack->size);
+    STACK_STAT_ADD(stack->stats, pops, popped);
+    if (out_popped)
+        *out_popped = popped;
+
+    StackError err = popped < count ? STACK_EMPTY : STACK_OK;
+    if (err == STACK_EMPTY)
+        STACK_STAT_ADD(stack->stats, empty_rejections, 1);
+    STACK_SET_ERROR(err);
+    return err;
+}
+
 StackError stack_dyn_pop(StackDyn *stack, void **out_data)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!out_data)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
+    if (stack->elem_size)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
     if (stack->size == 0)
     {
-        stack_last_error = STACK_EMPTY;
+        STACK_STAT_ADD(stack->stats, empty_rejections, 1);
+        STACK_SET_ERROR(STACK_EMPTY);
         return STACK_EMPTY;
     }
 
+    STACK_TRACE_BEGIN(stack->trace);
+    if (stack->chunked)
+        *out_data = stack_dyn_chunk_pop(stack);
+    else
+    {
+        StNode *node = stack->top;
+        stack->top = node->next;
+
+        *out_data = (void *) node->data;
+        stack_dyn_node_free(stack, node);
+    }
+    --stack->size;
+    stack_event_update(&stack->event, stack->size + 1, stack->size);
+    STACK_STAT_ADD(stack->stats, pops, 1);
+    STACK_TRACE_END(stack->trace, STACK_TRACE_POP);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_pop_into(StackDyn *stack, void *out_buffer)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_buffer)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    if (!stack->elem_size)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    if (stack->size == 0)
+    {
+        STACK_STAT_ADD(stack->stats, empty_rejections, 1);
+        STACK_SET_ERROR(STACK_EMPTY);
+        return STACK_EMPTY;
+    }
+
+    STACK_TRACE_BEGIN(stack->trace);
     StNode *node = stack->top;
     stack->top = node->next;
 
-    *out_data = (void *) node->data;
-    free(node);
+    memcpy(out_buffer, node->data, stack->elem_size);
+    stack_dyn_node_free(stack, node);
     --stack->size;
+    stack_event_update(&stack->event, stack->size + 1, stack->size);
+    STACK_STAT_ADD(stack->stats, pops, 1);
+    STACK_STAT_ADD(stack->stats, bytes_copied, stack->elem_size);
+    STACK_TRACE_END(stack->trace, STACK_TRACE_POP);
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -111,25 +562,28 @@ StackError stack_dyn_peek(const StackDyn *stack, void **out_data)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!out_data)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
     if (stack->size == 0)
     {
-        stack_last_error = STACK_EMPTY;
+        STACK_SET_ERROR(STACK_EMPTY);
         return STACK_EMPTY;
     }
 
-    *out_data = (void *) stack->top->data;
+    if (stack->chunked)
+        *out_data = stack->chunk->items[stack->chunk_used - 1];
+    else
+        *out_data = (void *) stack->top->data;
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -137,18 +591,18 @@ StackError stack_dyn_is_empty(const StackDyn *stack, bool *out_empty)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if(!out_empty)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
     *out_empty = stack->size == 0;
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -156,18 +610,18 @@ StackError stack_dyn_size(const StackDyn *stack, size_t *out_size)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!out_size)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
     *out_size = stack->size;
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -175,27 +629,60 @@ StackError stack_dyn_clear(StackDyn *stack)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
-    StNode *node = stack->top;
-    StNode *temp = NULL;
+    STACK_TRACE_BEGIN(stack->trace);
+    if (stack->destroy)
+    {
+        for (StNode *node = stack->top; node; node = node->next)
+            stack->destroy(node->data);
+    }
+
+    StChunk *chunk = stack->chunk;
+    size_t used = stack->chunk_used;
 
-    while (node)
+    while (chunk)
     {
-        temp = node;
-        node = node->next;
+        StChunk *prev = chunk->prev;
 
         if (stack->destroy)
-            stack->destroy(temp->data);
-        free(temp);
+        {
+            for (size_t i = 0; i < used; ++i)
+                stack->destroy(chunk->items[i]);
+        }
+
+        stack->allocator.free(stack->allocator.ctx, chunk, sizeof(StChunk));
+        chunk = prev;
+        used = STACK_DYN_CHUNK_ITEMS;
     }
+    if (stack->spare_chunk)
+        stack->allocator.free(stack->allocator.ctx, stack->spare_chunk, sizeof(StChunk));
+
+    StSlab *slab = stack->slabs;
+    StSlab *temp = NULL;
 
+    while (slab)
+    {
+        temp = slab;
+        slab = slab->next;
+        stack->allocator.free(stack->allocator.ctx, temp, stack_dyn_slab_size(stack));
+    }
+
+    size_t old_size = stack->size;
     stack->top = NULL;
     stack->size = 0;
-
-    stack_last_error = STACK_OK;
+    stack_event_update(&stack->event, old_size, 0);
+    stack->free_nodes = NULL;
+    stack->slabs = NULL;
+    stack->slab_used = 0;
+    stack->chunk = NULL;
+    stack->chunk_used = 0;
+    stack->spare_chunk = NULL;
+    STACK_TRACE_END(stack->trace, STACK_TRACE_CLEAR);
+
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -203,13 +690,122 @@ StackError stack_dyn_destroy(StackDyn *stack)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
+    stack_event_close(&stack->event);
     stack_dyn_clear(stack);
-    free(stack);
+#ifdef STACK_ENABLE_STATS
+    stack_stats_unregister(&stack->stats);
+#endif
+#ifdef STACK_ENABLE_TRACE
+    stack_trace_close(&stack->trace);
+#endif
+    stack->allocator.free(stack->allocator.ctx, stack, sizeof(StackDyn));
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_event_open(StackDyn *stack, size_t watermark, int *out_fd)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_fd)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StackError err = stack_event_open(&stack->event, watermark, out_fd);
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_dyn_event_ack(StackDyn *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    StackError err = stack_event_ack(&stack->event);
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_dyn_event_close(StackDyn *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    stack_event_close(&stack->event);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_stats(const StackDyn *stack, StackStats *out_stats)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_stats)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+#ifdef STACK_ENABLE_STATS
+    stack_stats_read(&stack->stats, out_stats);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+#else
+    STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+    return STACK_UNKNOWN_ERROR;
+#endif
+}
+
+StackError stack_dyn_latency(const StackDyn *stack, StackTraceOp op, StackLatency *out_latency)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((unsigned) op >= STACK_TRACE_OPS)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    if (!out_latency)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+#ifdef STACK_ENABLE_TRACE
+    stack_trace_read(&stack->trace, op, out_latency);
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
+#else
+    STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+    return STACK_UNKNOWN_ERROR;
+#endif
 }
@@ -0,0 +1,504 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stack_dyn_concurrent.h>
+
+// Index of the record the thread used last, tried first on the next pop.
+static _Thread_local size_t stack_hp_hint;
+
+// Takes a free hazard record, spinning while all of them are held.
+static StHazardRecord *stack_hp_acquire(StackDynConcurrent *stack)
+{
+    size_t index = stack_hp_hint;
+
+    for (;;)
+    {
+        for (size_t i = 0; i < STACK_HP_MAX_RECORDS; ++i)
+        {
+            StHazardRecord *record = &stack->records[index];
+            bool expected = false;
+
+            if (!atomic_load_explicit(&record->active, memory_order_relaxed) &&
+                atomic_compare_exchange_strong_explicit(&record->active, &expected, true,
+                                                        memory_order_acquire,
+                                                        memory_order_relaxed))
+            {
+                stack_hp_hint = index;
+                return record;
+            }
+
+            index = (index + 1) % STACK_HP_MAX_RECORDS;
+        }
+    }
+}
+
+// Releases a hazard record, the retired list stays with the record.
+static void stack_hp_release(StHazardRecord *record)
+{
+    atomic_store_explicit(&record->active, false, memory_order_release);
+}
+
+// Frees the retired nodes that no thread has protected.
+static void stack_hp_scan(StackDynConcurrent *stack, StHazardRecord *record)
+{
+    StNode *hazards[STACK_HP_MAX_RECORDS];
+    size_t hazard_count = 0;
+
+    for (size_t i = 0; i < STACK_HP_MAX_RECORDS; ++i)
+    {
+        StNode *node = atomic_load(&stack->records[i].hazard);
+        if (node)
+            hazards[hazard_count++] = node;
+    }
+
+    StNode *node = record->retired;
+    StNode *keep = NULL;
+    size_t keep_count = 0;
+
+    while (node)
+    {
+        StNode *next = node->data;
+        bool protected = false;
+
+        for (size_t i = 0; i < hazard_count && !protected; ++i)
+            protected = hazards[i] == node;
+
+        if (protected)
+        {
+            node->data = keep;
+            keep = node;
+            ++keep_count;
+        }
+        else
+            free(node);
+
+        node = next;
+    }
+
+    record->retired = keep;
+    record->retired_count = keep_count;
+}
+
+// Hands an unlinked node over to the reclamation.
+// Retired nodes are chained through data: a thread that still has the node
+// protected may read next, but never reads data of a node it did not pop.
+static void stack_hp_retire(StackDynConcurrent *stack, StHazardRecord *record, StNode *node)
+{
+    node->data = record->retired;
+    record->retired = node;
+
+    if (++record->retired_count >= STACK_HP_RETIRE_THRESHOLD)
+        stack_hp_scan(stack, record);
+}
+
+// Marks a slot whose offer was taken by a pop, cleared by the pushing thread.
+static StNode stack_elimination_taken;
+
+// State of the slot choice of the thread.
+static _Thread_local uint32_t stack_elimination_seed;
+
+// Picks a random slot among those in use.
+static StEliminationSlot *stack_elimination_pick(StackDynConcurrent *stack)
+{
+    uint32_t seed = stack_elimination_seed;
+    if (!seed)
+        seed = (uint32_t) (uintptr_t) &stack_elimination_seed | 1u;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    stack_elimination_seed = seed;
+
+    size_t width = atomic_load_explicit(&stack->elimination_width, memory_order_relaxed);
+    return &stack->elimination[seed % width];
+}
+
+// Spreads the operations over more slots after a collision.
+static void stack_elimination_widen(StackDynConcurrent *stack)
+{
+    size_t width = atomic_load_explicit(&stack->elimination_width, memory_order_relaxed);
+    if (width < stack->elimination_slots)
+        atomic_compare_exchange_weak_explicit(&stack->elimination_width, &width, width + 1,
+                                              memory_order_relaxed, memory_order_relaxed);
+}
+
+// Gathers the operations in fewer slots after an offer timed out.
+static void stack_elimination_narrow(StackDynConcurrent *stack)
+{
+    size_t width = atomic_load_explicit(&stack->elimination_width, memory_order_relaxed);
+    if (width > 1)
+        atomic_compare_exchange_weak_explicit(&stack->elimination_width, &width, width - 1,
+                                              memory_order_relaxed, memory_order_relaxed);
+}
+
+// Offers a node to the pops, returns true when a pop took it.
+static bool stack_elimination_push(StackDynConcurrent *stack, StNode *node)
+{
+    StEliminationSlot *slot = stack_elimination_pick(stack);
+    StNode *expected = NULL;
+
+    if (!atomic_compare_exchange_strong_explicit(&slot->offer, &expected, node,
+                                                 memory_order_release, memory_order_relaxed))
+    {
+        stack_elimination_widen(stack);
+        return false;
+    }
+
+    for (size_t i = 0; i < STACK_ELIMINATION_SPINS; ++i)
+    {
+        if (atomic_load_explicit(&slot->offer, memory_order_relaxed) == &stack_elimination_taken)
+        {
+            atomic_store_explicit(&slot->offer, NULL, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Withdraw the offer, unless a pop has just taken it
+    expected = node;
+    if (atomic_compare_exchange_strong_explicit(&slot->offer, &expected, NULL,
+                                                memory_order_relaxed, memory_order_relaxed))
+    {
+        stack_elimination_narrow(stack);
+        return false;
+    }
+
+    atomic_store_explicit(&slot->offer, NULL, memory_order_relaxed);
+    return true;
+}
+
+// Takes a node offered by a push, returns NULL when there is none.
+// The taken node never was on the stack, so it needs no hazard pointer.
+static StNode *stack_elimination_pop(StackDynConcurrent *stack)
+{
+    StEliminationSlot *slot = stack_elimination_pick(stack);
+    StNode *node = atomic_load_explicit(&slot->offer, memory_order_relaxed);
+
+    if (!node || node == &stack_elimination_taken)
+        return NULL;
+
+    if (atomic_compare_exchange_strong_explicit(&slot->offer, &node, &stack_elimination_taken,
+                                                memory_order_acquire, memory_order_relaxed))
+        return node;
+
+    stack_elimination_widen(stack);
+    return NULL;
+}
+
+StackError stack_dyn_concurrent_init(StackDynConcurrent **stack, stack_copy_data copy,
+                                     stack_destroy_data destroy)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((!copy && destroy) || (copy && !destroy))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    StackDynConcurrent *new_stack = aligned_alloc(STACK_CACHE_LINE, sizeof(StackDynConcurrent));
+    if (!new_stack)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    memset(new_stack, 0, sizeof(StackDynConcurrent));
+    atomic_init(&new_stack->top, NULL);
+    atomic_init(&new_stack->size, 0);
+    new_stack->copy = copy;
+    new_stack->destroy = destroy;
+    new_stack->elimination = NULL;
+    new_stack->elimination_slots = 0;
+    atomic_init(&new_stack->elimination_width, 0);
+
+    for (size_t i = 0; i < STACK_HP_MAX_RECORDS; ++i)
+    {
+        atomic_init(&new_stack->records[i].hazard, NULL);
+        atomic_init(&new_stack->records[i].active, false);
+        new_stack->records[i].retired = NULL;
+        new_stack->records[i].retired_count = 0;
+    }
+
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_concurrent_init_elimination(StackDynConcurrent **stack, stack_copy_data copy,
+                                                 stack_destroy_data destroy, size_t slots)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((slots == 0) || (slots > SIZE_MAX / sizeof(StEliminationSlot)))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    StackDynConcurrent *new_stack = NULL;
+    StackError err = stack_dyn_concurrent_init(&new_stack, copy, destroy);
+    if (err != STACK_OK)
+        return err;
+
+    new_stack->elimination = aligned_alloc(STACK_CACHE_LINE, slots * sizeof(StEliminationSlot));
+    if (!new_stack->elimination)
+    {
+        free(new_stack);
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    for (size_t i = 0; i < slots; ++i)
+        atomic_init(&new_stack->elimination[i].offer, NULL);
+    new_stack->elimination_slots = slots;
+    atomic_init(&new_stack->elimination_width, 1);
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_concurrent_push(StackDynConcurrent *stack, const void *data)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (stack->copy && !data)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    StNode *new_node = malloc(sizeof(StNode));
+    if (!new_node)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    if (stack->copy)
+    {
+        new_node->data = stack->copy(data);
+        if (!new_node->data)
+        {
+            free(new_node);
+            STACK_SET_ERROR(STACK_DATA_COPY_FAILED);
+            return STACK_DATA_COPY_FAILED;
+        }
+    }
+    else
+        new_node->data = (void *) data;
+
+    StNode *top = atomic_load_explicit(&stack->top, memory_order_relaxed);
+    for (;;)
+    {
+        new_node->next = top;
+        if (atomic_compare_exchange_weak_explicit(&stack->top, &top, new_node,
+                                                  memory_order_release,
+                                                  memory_order_relaxed))
+            break;
+
+        // Contention on top, try to hand the node to a pop directly
+        if (stack->elimination && stack_elimination_push(stack, new_node))
+        {
+            STACK_SET_ERROR(STACK_OK);
+            return STACK_OK;
+        }
+        top = atomic_load_explicit(&stack->top, memory_order_relaxed);
+    }
+
+    atomic_fetch_add_explicit(&stack->size, 1, memory_order_relaxed);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_concurrent_pop(StackDynConcurrent *stack, void **out_data)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StHazardRecord *record = stack_hp_acquire(stack);
+    StNode *top = NULL;
+    StNode *eliminated = NULL;
+
+    for (;;)
+    {
+        top = atomic_load(&stack->top);
+        if (!top)
+            break;
+
+        // Protect the node, then make sure it is still the top
+        atomic_store(&record->hazard, top);
+        if (atomic_load(&stack->top) != top)
+            continue;
+
+        StNode *next = top->next;
+        if (atomic_compare_exchange_weak(&stack->top, &top, next))
+            break;
+
+        // Contention on top, try to take a node from a push directly
+        if (stack->elimination && (eliminated = stack_elimination_pop(stack)))
+            break;
+    }
+
+    atomic_store_explicit(&record->hazard, NULL, memory_order_release);
+
+    if (eliminated)
+    {
+        stack_hp_release(record);
+        *out_data = eliminated->data;
+        free(eliminated);
+        STACK_SET_ERROR(STACK_OK);
+        return STACK_OK;
+    }
+
+    if (!top)
+    {
+        stack_hp_release(record);
+        STACK_SET_ERROR(STACK_EMPTY);
+        return STACK_EMPTY;
+    }
+
+    *out_data = top->data;
+    atomic_fetch_sub_explicit(&stack->size, 1, memory_order_relaxed);
+
+    stack_hp_retire(stack, record, top);
+    stack_hp_release(record);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_concurrent_is_empty(const StackDynConcurrent *stack, bool *out_empty)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_empty)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    *out_empty = atomic_load_explicit(&stack->top, memory_order_acquire) == NULL;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_concurrent_size(const StackDynConcurrent *stack, size_t *out_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_size)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    // Negative while a pop is counted before the push of its element
+    ptrdiff_t size = atomic_load_explicit(&stack->size, memory_order_relaxed);
+    *out_size = size > 0 ? (size_t) size : 0;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_concurrent_clear(StackDynConcurrent *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    StNode *node = atomic_exchange(&stack->top, NULL);
+    StHazardRecord *record = stack_hp_acquire(stack);
+
+    while (node)
+    {
+        StNode *next = node->next;
+
+        if (stack->destroy)
+            stack->destroy(node->data);
+        atomic_fetch_sub_explicit(&stack->size, 1, memory_order_relaxed);
+
+        stack_hp_retire(stack, record, node);
+        node = next;
+    }
+
+    stack_hp_release(record);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_dyn_concurrent_destroy(StackDynConcurrent *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    StNode *node = atomic_load(&stack->top);
+    StNode *temp = NULL;
+
+    while (node)
+    {
+        temp = node;
+        node = node->next;
+
+        if (stack->destroy)
+            stack->destroy(temp->data);
+        free(temp);
+    }
+
+    for (size_t i = 0; i < STACK_HP_MAX_RECORDS; ++i)
+    {
+        node = stack->records[i].retired;
+        while (node)
+        {
+            temp = node;
+            node = node->data;
+            free(temp);
+        }
+    }
+
+    free(stack->elimination);
+    free(stack);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
@@ -12,10 +12,11 @@ char *str_errors[] = {
     "STACK_NULL_OUT",
     "STACK_NULL_DATA",
     "STACK_UNKNOWN_ERROR",
+    "STACK_TIMEOUT",
 };
 
-// Global variable to store the last error
-StackError stack_last_error = STACK_OK;
+// Last error of each thread
+_Thread_local StackError stack_last_error = STACK_OK;
 
 // Function to get last error
 StackError stack_get_last_error(void)
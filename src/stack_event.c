@@ -0,0 +1,71 @@
+#include <stdint.h>
+#include <stack_event.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
+
+void stack_event_init(StStackEvent *event)
+{
+    event->fd = -1;
+    event->armed = false;
+    event->watermark = 0;
+}
+
+StackError stack_event_open(StStackEvent *event, size_t watermark, int *out_fd)
+{
+#ifdef __linux__
+    if (event->fd < 0)
+    {
+        event->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event->fd < 0)
+            return STACK_UNKNOWN_ERROR;
+    }
+
+    event->watermark = watermark;
+    event->armed = true;
+    *out_fd = event->fd;
+    return STACK_OK;
+#else
+    (void) event;
+    (void) watermark;
+    (void) out_fd;
+    return STACK_UNKNOWN_ERROR;
+#endif
+}
+
+StackError stack_event_ack(StStackEvent *event)
+{
+    if (event->fd < 0)
+        return STACK_INVALID_ARGS;
+
+#ifdef __linux__
+    uint64_t count = 0;
+    if (read(event->fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        return STACK_UNKNOWN_ERROR;
+#endif
+
+    event->armed = true;
+    return STACK_OK;
+}
+
+void stack_event_close(StStackEvent *event)
+{
+#ifdef __linux__
+    if (event->fd >= 0)
+        close(event->fd);
+#endif
+    stack_event_init(event);
+}
+
+void stack_event_signal(StStackEvent *event)
+{
+#ifdef __linux__
+    uint64_t one = 1;
+    if (write(event->fd, &one, sizeof(one)) < 0)
+        return;
+#endif
+    event->armed = false;
+}
@@ -0,0 +1,178 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include <stack_intrusive.h>
+
+StackError stack_intrusive_init(StackIntrusive *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    stack->top = NULL;
+    stack->bottom = NULL;
+    stack->size = 0;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_intrusive_clear(StackIntrusive *stack)
+{
+    return stack_intrusive_init(stack);
+}
+
+StackError stack_intrusive_push(StackIntrusive *stack, StackLink *link)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!link)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    link->next = stack->top;
+    if (!stack->top)
+        stack->bottom = link;
+    stack->top = link;
+    ++stack->size;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_intrusive_pop(StackIntrusive *stack, StackLink **out_link)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_link)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StackLink *link = stack->top;
+    if (!link)
+    {
+        STACK_SET_ERROR(STACK_EMPTY);
+        return STACK_EMPTY;
+    }
+
+    stack->top = link->next;
+    if (!stack->top)
+        stack->bottom = NULL;
+    --stack->size;
+    link->next = NULL;
+    *out_link = link;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_intrusive_peek(const StackIntrusive *stack, StackLink **out_link)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_link)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    if (!stack->top)
+    {
+        STACK_SET_ERROR(STACK_EMPTY);
+        return STACK_EMPTY;
+    }
+
+    *out_link = stack->top;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_intrusive_splice(StackIntrusive *stack, StackIntrusive *source)
+{
+    if (!stack || !source)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (stack == source)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    if (source->top)
+    {
+        // The bottom of source now rests on the old top
+        source->bottom->next = stack->top;
+        if (!stack->top)
+            stack->bottom = source->bottom;
+        stack->top = source->top;
+        stack->size += source->size;
+
+        source->top = NULL;
+        source->bottom = NULL;
+        source->size = 0;
+    }
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_intrusive_is_empty(const StackIntrusive *stack, bool *out_empty)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_empty)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    *out_empty = stack->size == 0;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_intrusive_size(const StackIntrusive *stack, size_t *out_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_size)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    *out_size = stack->size;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
@@ -1,48 +1,273 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <stack_pool.h>
+#include "stack_pool_internal.h"
+
+// Width of one step of the wide copy kernel.
+#define STACK_POOL_WIDE_STEP 64
+
+// Defines a copy kernel for blocks of a fixed size known at compile time.
+#define STACK_POOL_COPY_KERNEL(bytes) \
+    static void stack_pool_copy_##bytes(void *dst, const void *src, size_t size) \
+    { \
+        (void) size; \
+        memcpy(dst, src, bytes); \
+    }
+
+STACK_POOL_COPY_KERNEL(1)
+STACK_POOL_COPY_KERNEL(2)
+STACK_POOL_COPY_KERNEL(4)
+STACK_POOL_COPY_KERNEL(8)
+STACK_POOL_COPY_KERNEL(16)
+STACK_POOL_COPY_KERNEL(32)
+STACK_POOL_COPY_KERNEL(64)
+
+// Copies blocks of any other small size.
+static void stack_pool_copy_any(void *dst, const void *src, size_t size)
+{
+    memcpy(dst, src, size);
+}
+
+// Copies large blocks in fixed-width steps the compiler turns into vector moves.
+static void stack_pool_copy_wide(void *dst, const void *src, size_t size)
+{
+    byte *out = dst;
+    const byte *in = src;
+
+    while (size >= STACK_POOL_WIDE_STEP)
+    {
+        memcpy(out, in, STACK_POOL_WIDE_STEP);
+        out += STACK_POOL_WIDE_STEP;
+        in += STACK_POOL_WIDE_STEP;
+        size -= STACK_POOL_WIDE_STEP;
+    }
+
+    if (size)
+        memcpy(out, in, size);
+}
+
+stack_block_copy stack_pool_copy_kernel(size_t block_size)
+{
+    switch (block_size)
+    {
+        case 1: return stack_pool_copy_1;
+        case 2: return stack_pool_copy_2;
+        case 4: return stack_pool_copy_4;
+        case 8: return stack_pool_copy_8;
+        case 16: return stack_pool_copy_16;
+        case 32: return stack_pool_copy_32;
+        case 64: return stack_pool_copy_64;
+        default:
+            return block_size > STACK_POOL_WIDE_STEP ? stack_pool_copy_wide : stack_pool_copy_any;
+    }
+}
+
+// Copies count blocks between a packed array and pool blocks, either side may be strided.
+static void stack_pool_copy_run(const StackPool *stack, byte *dst, size_t dst_step,
+                                const byte *src, size_t src_step, size_t count)
+{
+    if (dst_step == stack->block_size && src_step == stack->block_size)
+    {
+        memcpy(dst, src, count * stack->block_size);
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        stack->copy_block(dst + i * dst_step, src + i * src_step, stack->block_size);
+}
+
+// Grows a full pool according to its growth policy.
+static StackError stack_pool_grow(StackPool *stack)
+{
+    if (stack->growth == STACK_POOL_FIXED || stack->capacity >= stack->max_capacity)
+        return STACK_FULL;
+
+    size_t extra = stack->capacity;
+    if (extra > stack->max_capacity - stack->capacity)
+        extra = stack->max_capacity - stack->capacity;
+
+    size_t new_capacity = stack->capacity + extra;
+
+    if (stack->growth == STACK_POOL_DOUBLE)
+    {
+        byte *pool = stack->allocator.realloc(stack->allocator.ctx, stack->pool,
+                                              stack->capacity * stack->stride,
+                                              new_capacity * stack->stride);
+        if (!pool)
+            return STACK_ALLOC_FAILED;
+
+        stack->top = pool + ((byte *) stack->top - (byte *) stack->pool);
+        stack->pool = pool;
+        stack->base = pool;
+        stack->end = pool + new_capacity * stack->stride;
+    }
+    else
+    {
+        byte *block = stack->allocator.alloc(stack->allocator.ctx, extra * stack->stride);
+        if (!block)
+            return STACK_ALLOC_FAILED;
+
+        size_t count = stack->segment_count;
+        StPoolSegment *segments = stack->allocator.realloc(stack->allocator.ctx, stack->segments,
+                                                           count * sizeof(StPoolSegment),
+                                                           (count + 1) * sizeof(StPoolSegment));
+        if (!segments)
+        {
+            stack->allocator.free(stack->allocator.ctx, block, extra * stack->stride);
+            return STACK_ALLOC_FAILED;
+        }
+        stack->segments = segments;
+
+        segments[count].base = block;
+        segments[count].end = block + extra * stack->stride;
+        stack->segment_count = count + 1;
+    }
+
+    stack->capacity = new_capacity;
+    STACK_STAT_ADD(stack->stats, allocations, 1);
+    return STACK_OK;
+}
+
+// Moves the top to the next free block, growing the pool when it is full.
+static StackError stack_pool_advance(StackPool *stack)
+{
+    if (stack->size == stack->capacity)
+    {
+        StackError err = stack->growth == STACK_POOL_SPILL ? stack_pool_spill(stack)
+                                                           : stack_pool_grow(stack);
+        if (err != STACK_OK)
+            return err;
+    }
+
+    if (stack->size)
+    {
+        byte *next = (byte *) stack->top + stack->stride;
+        if (next == stack->end && stack->storage == STACK_POOL_RESERVED)
+        {
+            StackError err = stack_pool_commit(stack);
+            if (err != STACK_OK)
+                return err;
+        }
+        else if (next == stack->end)
+        {
+            StPoolSegment *segment = &stack->segments[++stack->segment];
+            next = segment->base;
+            stack->base = segment->base;
+            stack->end = segment->end;
+        }
+        stack->top = next;
+    }
+
+    return STACK_OK;
+}
+
+// Moves the top to the previous block, the stack must hold at least two elements.
+static void stack_pool_retreat(StackPool *stack)
+{
+    if (stack->top == stack->base)
+    {
+        StPoolSegment *segment = &stack->segments[--stack->segment];
+        stack->top = (byte *) segment->end - stack->stride;
+        stack->base = segment->base;
+        stack->end = segment->end;
+    }
+    else
+        stack->top = (byte *) stack->top - stack->stride;
+}
 
 StackError stack_pool_init(StackPool **stack, size_t capacity, size_t block_size)
 {
-    if (!stack)
+    return stack_pool_init_growable(stack, capacity, block_size, STACK_POOL_FIXED, capacity);
+}
+
+StackError stack_pool_init_growable(StackPool **stack, size_t capacity, size_t block_size,
+                                    StackPoolGrowth growth, size_t max_capacity)
+{
+    return stack_pool_init_allocator(stack, capacity, block_size, growth, max_capacity,
+                                     &stack_allocator_malloc);
+}
+
+StackError stack_pool_init_allocator(StackPool **stack, size_t capacity, size_t block_size,
+                                     StackPoolGrowth growth, size_t max_capacity,
+                                     const StackAllocator *allocator)
+{
+    if (!stack || !allocator)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
-    if ((capacity == 0) || (block_size == 0))
+    if ((capacity == 0) || (block_size == 0) ||
+        !allocator->alloc || !allocator->realloc || !allocator->free)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    if (max_capacity == 0 || max_capacity > SIZE_MAX / block_size)
+        max_capacity = SIZE_MAX / block_size;
+
+    if ((growth != STACK_POOL_FIXED && growth != STACK_POOL_DOUBLE &&
+         growth != STACK_POOL_SEGMENTED) || max_capacity < capacity)
     {
-        stack_last_error = STACK_INVALID_ARGS;
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
         return STACK_INVALID_ARGS;
     }
 
-    StackPool *new_stack = calloc(1, sizeof(StackPool));
+    StackPool *new_stack = allocator->alloc(allocator->ctx, sizeof(StackPool));
     if (!new_stack)
     {
-        stack_last_error = STACK_ALLOC_FAILED;
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
         return STACK_ALLOC_FAILED;
     }
+    memset(new_stack, 0, sizeof(StackPool));
+    new_stack->allocator = *allocator;
 
-    byte (*pool)[block_size] = calloc(capacity, block_size);
+    byte *pool = allocator->alloc(allocator->ctx, capacity * block_size);
     if (!pool)
         goto pool_allocation_error;
 
+    if (growth == STACK_POOL_SEGMENTED)
+    {
+        new_stack->segments = allocator->alloc(allocator->ctx, sizeof(StPoolSegment));
+        if (!new_stack->segments)
+            goto segments_allocation_error;
+
+        new_stack->segments[0].base = pool;
+        new_stack->segments[0].end = pool + capacity * block_size;
+        new_stack->segment_count = 1;
+    }
+
     new_stack->pool = pool;
     new_stack->top = pool;
     new_stack->capacity = capacity;
     new_stack->block_size = block_size;
+    new_stack->stride = block_size;
     new_stack->size = 0;
+    new_stack->base = pool;
+    new_stack->end = pool + capacity * block_size;
+    new_stack->growth = growth;
+    new_stack->max_capacity = growth == STACK_POOL_FIXED ? capacity : max_capacity;
+    new_stack->segment = 0;
+    new_stack->copy_block = stack_pool_copy_kernel(block_size);
+    stack_event_init(&new_stack->event);
+    stack_pool_stats_init(new_stack);
+    new_stack->storage = STACK_POOL_HEAP;
     *stack = new_stack;
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 
 
+    segments_allocation_error:
+        allocator->free(allocator->ctx, pool, capacity * block_size);
     pool_allocation_error:
-        free(new_stack);
+        allocator->free(allocator->ctx, new_stack, sizeof(StackPool));
 
-    stack_last_error = STACK_ALLOC_FAILED;
+    STACK_SET_ERROR(STACK_ALLOC_FAILED);
     return STACK_ALLOC_FAILED;
 }
 
@@ -50,14 +275,27 @@ StackError stack_pool_clear(StackPool *stack)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
+    STACK_TRACE_BEGIN(stack->trace);
+    size_t old_size = stack->size;
     stack->top = stack->pool;
     stack->size = 0;
+    stack->spilled = 0;
+    if (stack->storage == STACK_POOL_RESERVED)
+        stack_pool_trim(stack);
+    stack_event_update(&stack->event, old_size, 0);
+    if (stack->segments)
+    {
+        stack->segment = 0;
+        stack->base = stack->segments[0].base;
+        stack->end = stack->segments[0].end;
+    }
+    STACK_TRACE_END(stack->trace, STACK_TRACE_CLEAR);
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -65,14 +303,36 @@ StackError stack_pool_destroy(StackPool *stack)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
     
-    free(stack->pool);
-    free(stack);
+    StackAllocator allocator = stack->allocator;
 
-    stack_last_error = STACK_OK;
+    if (stack->storage != STACK_POOL_HEAP)
+        stack_pool_unmap(stack);
+    else if (stack->segments)
+    {
+        for (size_t i = 0; i < stack->segment_count; ++i)
+            allocator.free(allocator.ctx, stack->segments[i].base,
+                           (byte *) stack->segments[i].end - (byte *) stack->segments[i].base);
+        allocator.free(allocator.ctx, stack->segments,
+                       stack->segment_count * sizeof(StPoolSegment));
+    }
+    else
+        allocator.free(allocator.ctx, stack->pool, stack->capacity * stack->stride);
+    if (stack->growth == STACK_POOL_SPILL)
+        stack_pool_spill_close(stack);
+    stack_event_close(&stack->event);
+#ifdef STACK_ENABLE_STATS
+    stack_stats_unregister(&stack->stats);
+#endif
+#ifdef STACK_ENABLE_TRACE
+    stack_trace_close(&stack->trace);
+#endif
+    allocator.free(allocator.ctx, stack, sizeof(StackPool));
+
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -80,67 +340,281 @@ StackError stack_pool_push(StackPool *stack, const void *data)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!data)
     {
-        stack_last_error = STACK_NULL_DATA;
+        STACK_SET_ERROR(STACK_NULL_DATA);
         return STACK_NULL_DATA;
     }
 
-    if (stack->size == stack->capacity)
+    STACK_TRACE_BEGIN(stack->trace);
+    StackError err = stack_pool_advance(stack);
+    if (err != STACK_OK)
     {
-        stack_last_error = STACK_FULL;
-        return STACK_FULL;
+        if (err == STACK_FULL)
+            STACK_STAT_ADD(stack->stats, full_rejections, 1);
+        STACK_SET_ERROR(err);
+        return err;
     }
 
-    if (stack->size)
-        stack->top = stack->top + stack->block_size;
-
-    byte *block = stack->top;
-    byte *data_byte = (void *) data;
-    for (int i = 0; i < stack->block_size; ++i)
-        *(block + i) = *(data_byte +i);
+    stack->copy_block(stack->top, data, stack->block_size);
 
     ++stack->size;
+    stack_event_update(&stack->event, stack->size - 1, stack->size);
+    STACK_STAT_ADD(stack->stats, pushes, 1);
+    STACK_STAT_ADD(stack->stats, bytes_copied, stack->block_size);
+    STACK_STAT_MAX(stack->stats, high_water, stack->size + stack->spilled);
+    STACK_TRACE_END(stack->trace, STACK_TRACE_PUSH);
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
+StackError stack_pool_push_n(StackPool *stack, const void *data, size_t count, size_t *out_pushed)
+{
+    if (out_pushed)
+        *out_pushed = 0;
+
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!data && count)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    const byte *src = data;
+    size_t pushed = 0;
+    size_t old_size = stack->size;
+    StackError err = STACK_OK;
+
+    while (pushed < count)
+    {
+        err = stack_pool_advance(stack);
+        if (err != STACK_OK)
+            break;
+
+        // Copy the longest run that fits into the memory holding the top
+        size_t run = ((byte *) stack->end - (byte *) stack->top) / stack->stride;
+        if (run > stack->capacity - stack->size)
+            run = stack->capacity - stack->size;
+        if (run > count - pushed)
+            run = count - pushed;
+
+        stack_pool_copy_run(stack, stack->top, stack->stride, src, stack->block_size, run);
+        stack->top = (byte *) stack->top + (run - 1) * stack->stride;
+        stack->size += run;
+        src += run * stack->block_size;
+        pushed += run;
+    }
+
+    stack_event_update(&stack->event, old_size, stack->size);
+    STACK_STAT_ADD(stack->stats, pushes, pushed);
+    STACK_STAT_ADD(stack->stats, bytes_copied, pushed * stack->block_size);
+    STACK_STAT_MAX(stack->stats, high_water, stack->size + stack->spilled);
+    if (err == STACK_FULL)
+        STACK_STAT_ADD(stack->stats, full_rejections, 1);
+
+    if (out_pushed)
+        *out_pushed = pushed;
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_pop_n(StackPool *stack, void *out_data, size_t count, size_t *out_popped)
+{
+    if (out_popped)
+        *out_popped = 0;
+
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data && count)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    size_t old_size = stack->size;
+    size_t total = stack->size + stack->spilled;
+    size_t popped = count < total ? count : total;
+    size_t remaining = popped;
+    byte *dst = (byte *) out_data + popped * stack->block_size;
+    StackError err = popped < count ? STACK_EMPTY : STACK_OK;
+
+    // Blocks keep their stack order, the former top ends up last
+    while (remaining)
+    {
+        if (stack->spilled && stack->size <= 1 && stack_pool_refill(stack) != STACK_OK)
+        {
+            // Move what was popped to the beginning, as if the stack ran out
+            popped -= remaining;
+            memmove(out_data, dst, popped * stack->block_size);
+            err = STACK_UNKNOWN_ERROR;
+            break;
+        }
+
+        size_t run = ((byte *) stack->top - (byte *) stack->base) / stack->stride + 1;
+        if (run > remaining)
+            run = remaining;
+        // The last block in memory stays until the spilled ones are read back
+        if (stack->spilled && run == stack->size)
+            --run;
+
+        byte *src = (byte *) stack->top - (run - 1) * stack->stride;
+        dst -= run * stack->block_size;
+        stack_pool_copy_run(stack, dst, stack->block_size, src, stack->stride, run);
+
+        remaining -= run;
+        stack->size -= run;
+        stack->top = src;
+        if (stack->size)
+            stack_pool_retreat(stack);
+    }
+
+    if (stack->storage == STACK_POOL_RESERVED)
+        stack_pool_trim(stack);
+    stack_event_update(&stack->event, old_size, stack->size);
+    STACK_STAT_ADD(stack->stats, pops, popped);
+    STACK_STAT_ADD(stack->stats, bytes_copied, popped * stack->block_size);
+    if (err == STACK_EMPTY)
+        STACK_STAT_ADD(stack->stats, empty_rejections, 1);
+
+    if (out_popped)
+        *out_popped = popped;
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
 StackError stack_pool_pop(StackPool *stack, void *out_data)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!out_data)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
     if (stack->size == 0)
     {
-        stack_last_error = STACK_EMPTY;
+        STACK_STAT_ADD(stack->stats, empty_rejections, 1);
+        STACK_SET_ERROR(STACK_EMPTY);
         return STACK_EMPTY;
     }
 
-    byte *block = (byte *) stack->top;
-    byte *output = (byte *) out_data;
-    for (int i = 0; i < stack->block_size; ++i)
-        *(output + i) = *(block + i);
+    STACK_TRACE_BEGIN(stack->trace);
+    if (stack->spilled && stack->size == 1)
+    {
+        StackError err = stack_pool_refill(stack);
+        if (err != STACK_OK)
+        {
+            STACK_SET_ERROR(err);
+            return err;
+        }
+    }
+
+    stack->copy_block(out_data, stack->top, stack->block_size);
 
     if (stack->size > 1)
-        stack->top = stack->top - stack->block_size;
+        stack_pool_retreat(stack);
 
     --stack->size;
+    if (stack->storage == STACK_POOL_RESERVED)
+        stack_pool_trim(stack);
+    stack_event_update(&stack->event, stack->size + 1, stack->size);
+    STACK_STAT_ADD(stack->stats, pops, 1);
+    STACK_STAT_ADD(stack->stats, bytes_copied, stack->block_size);
+    STACK_TRACE_END(stack->trace, STACK_TRACE_POP);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_push_slot(StackPool *stack, void **out_slot)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_slot)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StackError err = stack_pool_advance(stack);
+    if (err != STACK_OK)
+    {
+        if (err == STACK_FULL)
+            STACK_STAT_ADD(stack->stats, full_rejections, 1);
+        STACK_SET_ERROR(err);
+        return err;
+    }
+
+    *out_slot = stack->top;
+    ++stack->size;
+    stack_event_update(&stack->event, stack->size - 1, stack->size);
+    STACK_STAT_ADD(stack->stats, pushes, 1);
+    STACK_STAT_MAX(stack->stats, high_water, stack->size + stack->spilled);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_drop(StackPool *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (stack->size == 0)
+    {
+        STACK_STAT_ADD(stack->stats, empty_rejections, 1);
+        STACK_SET_ERROR(STACK_EMPTY);
+        return STACK_EMPTY;
+    }
+
+    if (stack->spilled && stack->size == 1)
+    {
+        StackError err = stack_pool_refill(stack);
+        if (err != STACK_OK)
+        {
+            STACK_SET_ERROR(err);
+            return err;
+        }
+    }
+
+    if (stack->size > 1)
+        stack_pool_retreat(stack);
+
+    --stack->size;
+    if (stack->storage == STACK_POOL_RESERVED)
+        stack_pool_trim(stack);
+    stack_event_update(&stack->event, stack->size + 1, stack->size);
+    STACK_STAT_ADD(stack->stats, pops, 1);
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -148,28 +622,51 @@ StackError stack_pool_peek(const StackPool *stack, void *out_data)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!out_data)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    if (stack->size == 0)
+    {
+        STACK_SET_ERROR(STACK_EMPTY);
+        return STACK_EMPTY;
+    }
+
+    stack->copy_block(out_data, stack->top, stack->block_size);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_top_ptr(const StackPool *stack, void **out_block)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_block)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
     if (stack->size == 0)
     {
-        stack_last_error = STACK_EMPTY;
+        STACK_SET_ERROR(STACK_EMPTY);
         return STACK_EMPTY;
     }
 
-    byte *block = (byte *) stack->top;
-    byte *output = (byte *) out_data;
-    for (int i = 0; i < stack->block_size; ++i)
-        *(output + i) = *(block + i);
+    *out_block = stack->top;
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -177,19 +674,19 @@ StackError stack_pool_is_empty(const StackPool *stack, bool *out_empty)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!out_empty)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
     *out_empty = stack->size == 0;
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
 }
 
@@ -197,18 +694,120 @@ StackError stack_pool_size(const StackPool *stack, size_t *out_size)
 {
     if (!stack)
     {
-        stack_last_error = STACK_NULL_PTR;
+        STACK_SET_ERROR(STACK_NULL_PTR);
         return STACK_NULL_PTR;
     }
 
     if (!out_size)
     {
-        stack_last_error = STACK_NULL_OUT;
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    *out_size = stack->size + stack->spilled;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_event_open(StackPool *stack, size_t watermark, int *out_fd)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_fd)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StackError err = stack_event_open(&stack->event, watermark, out_fd);
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_event_ack(StackPool *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    StackError err = stack_event_ack(&stack->event);
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_event_close(StackPool *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    stack_event_close(&stack->event);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_stats(const StackPool *stack, StackStats *out_stats)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_stats)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+#ifdef STACK_ENABLE_STATS
+    stack_stats_read(&stack->stats, out_stats);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+#else
+    STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+    return STACK_UNKNOWN_ERROR;
+#endif
+}
+
+StackError stack_pool_latency(const StackPool *stack, StackTraceOp op, StackLatency *out_latency)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((unsigned) op >= STACK_TRACE_OPS)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    if (!out_latency)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
         return STACK_NULL_OUT;
     }
 
-    *out_size = stack->size;
+#ifdef STACK_ENABLE_TRACE
+    stack_trace_read(&stack->trace, op, out_latency);
 
-    stack_last_error = STACK_OK;
+    STACK_SET_ERROR(STACK_OK);
     return STACK_OK;
+#else
+    STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+    return STACK_UNKNOWN_ERROR;
+#endif
 }
@@ -0,0 +1,120 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <stack_pool.h>
+#include "stack_pool_internal.h"
+
+// Size of a transparent or explicit huge page.
+#define STACK_POOL_HUGE_PAGE (2u * 1024 * 1024)
+
+static size_t stack_pool_round(size_t bytes, size_t align)
+{
+    return (bytes + align - 1) / align * align;
+}
+
+// Allocates the pool memory, returns NULL on failure.
+static void *stack_pool_aligned_alloc(StackPool *stack, size_t length, size_t align,
+                                      StackPoolPages pages)
+{
+    if (pages == STACK_POOL_PAGES_HUGETLB)
+    {
+#ifdef MAP_HUGETLB
+        length = stack_pool_round(length, STACK_POOL_HUGE_PAGE);
+        void *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapping == MAP_FAILED)
+            return NULL;
+
+        stack->storage = STACK_POOL_ANONYMOUS;
+        stack->mapping = mapping;
+        stack->mapping_size = length;
+        return mapping;
+#else
+        return NULL;
+#endif
+    }
+
+    if (pages == STACK_POOL_PAGES_TRANSPARENT && length >= STACK_POOL_HUGE_PAGE)
+        align = align > STACK_POOL_HUGE_PAGE ? align : STACK_POOL_HUGE_PAGE;
+
+    void *pool = aligned_alloc(align, stack_pool_round(length, align));
+    if (!pool)
+        return NULL;
+
+#ifdef MADV_HUGEPAGE
+    // Only a hint, the kernel may have transparent huge pages disabled
+    if (pages == STACK_POOL_PAGES_TRANSPARENT && align >= STACK_POOL_HUGE_PAGE)
+        madvise(pool, stack_pool_round(length, align), MADV_HUGEPAGE);
+#endif
+
+    stack->storage = STACK_POOL_HEAP;
+    return pool;
+}
+
+StackError stack_pool_init_aligned(StackPool **stack, size_t capacity, size_t block_size,
+                                   size_t align, StackPoolPages pages)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (align == 0)
+        align = 1;
+
+    if ((capacity == 0) || (block_size == 0) || (align & (align - 1)) ||
+        (block_size > SIZE_MAX - align) || (pages != STACK_POOL_PAGES_DEFAULT &&
+        pages != STACK_POOL_PAGES_TRANSPARENT && pages != STACK_POOL_PAGES_HUGETLB))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    size_t stride = stack_pool_round(block_size, align);
+    if (capacity > (SIZE_MAX - STACK_POOL_HUGE_PAGE) / stride)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    StackPool *new_stack = calloc(1, sizeof(StackPool));
+    if (!new_stack)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    // aligned_alloc() needs at least the alignment of a pointer
+    byte *pool = stack_pool_aligned_alloc(new_stack, capacity * stride,
+                                          align > sizeof(void *) ? align : sizeof(void *), pages);
+    if (!pool)
+    {
+        free(new_stack);
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    new_stack->pool = pool;
+    new_stack->top = pool;
+    new_stack->capacity = capacity;
+    new_stack->block_size = block_size;
+    new_stack->stride = stride;
+    new_stack->size = 0;
+    new_stack->base = pool;
+    new_stack->end = pool + capacity * stride;
+    new_stack->growth = STACK_POOL_FIXED;
+    new_stack->max_capacity = capacity;
+    new_stack->copy_block = stack_pool_copy_kernel(block_size);
+    stack_event_init(&new_stack->event);
+    new_stack->allocator = stack_allocator_malloc;
+    stack_pool_stats_init(new_stack);
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
@@ -0,0 +1,247 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+#include <time.h>
+#include <stack_pool_blocking.h>
+
+// Computes the monotonic time timeout_ns from now.
+static void stack_blocking_deadline(struct timespec *deadline, int64_t timeout_ns)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += (time_t) (timeout_ns / 1000000000);
+    deadline->tv_nsec += (long) (timeout_ns % 1000000000);
+    if (deadline->tv_nsec >= 1000000000)
+    {
+        ++deadline->tv_sec;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+// Waits on cond until it is signaled or the deadline passes (NULL waits forever).
+static StackError stack_blocking_wait(pthread_cond_t *cond, pthread_mutex_t *lock,
+                                      const struct timespec *deadline)
+{
+    if (!deadline)
+        return pthread_cond_wait(cond, lock) == 0 ? STACK_OK : STACK_UNKNOWN_ERROR;
+
+    int rc = pthread_cond_timedwait(cond, lock, deadline);
+    if (rc == ETIMEDOUT)
+        return STACK_TIMEOUT;
+    return rc == 0 ? STACK_OK : STACK_UNKNOWN_ERROR;
+}
+
+StackError stack_pool_blocking_init(StackPoolBlocking **stack, size_t capacity, size_t block_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((capacity == 0) || (block_size == 0))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    StackPoolBlocking *new_stack = malloc(sizeof(StackPoolBlocking));
+    if (!new_stack)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    pthread_condattr_t attr;
+    if (stack_pool_init(&new_stack->pool, capacity, block_size) != STACK_OK)
+        goto pool_allocation_error;
+    if (pthread_mutex_init(&new_stack->lock, NULL) != 0)
+        goto lock_init_error;
+    if (pthread_condattr_init(&attr) != 0)
+        goto attr_init_error;
+
+    // Timeouts are measured on the monotonic clock
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (pthread_cond_init(&new_stack->not_full, &attr) != 0)
+        goto not_full_init_error;
+    if (pthread_cond_init(&new_stack->not_empty, &attr) != 0)
+        goto not_empty_init_error;
+    pthread_condattr_destroy(&attr);
+
+    new_stack->push_waiters = 0;
+    new_stack->pop_waiters = 0;
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+
+
+    not_empty_init_error:
+        pthread_cond_destroy(&new_stack->not_full);
+    not_full_init_error:
+        pthread_condattr_destroy(&attr);
+    attr_init_error:
+        pthread_mutex_destroy(&new_stack->lock);
+    lock_init_error:
+        stack_pool_destroy(new_stack->pool);
+    pool_allocation_error:
+        free(new_stack);
+
+    STACK_SET_ERROR(STACK_ALLOC_FAILED);
+    return STACK_ALLOC_FAILED;
+}
+
+StackError stack_pool_blocking_destroy(StackPoolBlocking *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    pthread_cond_destroy(&stack->not_empty);
+    pthread_cond_destroy(&stack->not_full);
+    pthread_mutex_destroy(&stack->lock);
+    stack_pool_destroy(stack->pool);
+    free(stack);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_blocking_push_wait(StackPoolBlocking *stack, const void *data,
+                                         int64_t timeout_ns)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!data)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    struct timespec deadline;
+    bool deadline_set = false;
+    StackError err = STACK_OK;
+
+    pthread_mutex_lock(&stack->lock);
+
+    while (stack->pool->size == stack->pool->capacity)
+    {
+        if (timeout_ns == 0 || err != STACK_OK)
+        {
+            pthread_mutex_unlock(&stack->lock);
+            err = timeout_ns == 0 ? STACK_FULL : err;
+            STACK_SET_ERROR(err);
+            return err;
+        }
+
+        if (timeout_ns > 0 && !deadline_set)
+        {
+            stack_blocking_deadline(&deadline, timeout_ns);
+            deadline_set = true;
+        }
+
+        ++stack->push_waiters;
+        err = stack_blocking_wait(&stack->not_full, &stack->lock, deadline_set ? &deadline : NULL);
+        --stack->push_waiters;
+    }
+
+    stack_pool_push(stack->pool, data);
+    if (stack->pop_waiters)
+        pthread_cond_signal(&stack->not_empty);
+
+    pthread_mutex_unlock(&stack->lock);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_blocking_pop_wait(StackPoolBlocking *stack, void *out_data,
+                                        int64_t timeout_ns)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    struct timespec deadline;
+    bool deadline_set = false;
+    StackError err = STACK_OK;
+
+    pthread_mutex_lock(&stack->lock);
+
+    while (stack->pool->size == 0)
+    {
+        if (timeout_ns == 0 || err != STACK_OK)
+        {
+            pthread_mutex_unlock(&stack->lock);
+            err = timeout_ns == 0 ? STACK_EMPTY : err;
+            STACK_SET_ERROR(err);
+            return err;
+        }
+
+        if (timeout_ns > 0 && !deadline_set)
+        {
+            stack_blocking_deadline(&deadline, timeout_ns);
+            deadline_set = true;
+        }
+
+        ++stack->pop_waiters;
+        err = stack_blocking_wait(&stack->not_empty, &stack->lock, deadline_set ? &deadline : NULL);
+        --stack->pop_waiters;
+    }
+
+    stack_pool_pop(stack->pool, out_data);
+    if (stack->push_waiters)
+        pthread_cond_signal(&stack->not_full);
+
+    pthread_mutex_unlock(&stack->lock);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_blocking_push(StackPoolBlocking *stack, const void *data)
+{
+    return stack_pool_blocking_push_wait(stack, data, 0);
+}
+
+StackError stack_pool_blocking_pop(StackPoolBlocking *stack, void *out_data)
+{
+    return stack_pool_blocking_pop_wait(stack, out_data, 0);
+}
+
+StackError stack_pool_blocking_size(StackPoolBlocking *stack, size_t *out_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_size)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    pthread_mutex_lock(&stack->lock);
+    *out_size = stack->pool->size;
+    pthread_mutex_unlock(&stack->lock);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
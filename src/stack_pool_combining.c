@@ -0,0 +1,375 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <threads.h>
+#include <stack_pool_combining.h>
+
+// Index of the slot the thread used last, tried first on the next request.
+static _Thread_local size_t stack_fc_hint;
+
+// Takes a free publication slot, spinning while all of them are held.
+static StFcSlot *stack_fc_acquire(StackPoolCombining *stack)
+{
+    size_t index = stack_fc_hint;
+
+    for (;;)
+    {
+        for (size_t i = 0; i < STACK_FC_MAX_SLOTS; ++i)
+        {
+            StFcSlot *slot = &stack->slots[index];
+            bool expected = false;
+
+            if (!atomic_load_explicit(&slot->active, memory_order_relaxed) &&
+                atomic_compare_exchange_strong_explicit(&slot->active, &expected, true,
+                                                        memory_order_acquire,
+                                                        memory_order_relaxed))
+            {
+                size_t count = atomic_load_explicit(&stack->slot_count, memory_order_relaxed);
+                while (count <= index &&
+                       !atomic_compare_exchange_weak_explicit(&stack->slot_count, &count, index + 1,
+                                                              memory_order_relaxed,
+                                                              memory_order_relaxed))
+                    ;
+
+                stack_fc_hint = index;
+                return slot;
+            }
+
+            index = (index + 1) % STACK_FC_MAX_SLOTS;
+        }
+        thrd_yield();
+    }
+}
+
+// Takes the combiner lock if it is free.
+static bool stack_fc_try_lock(StackPoolCombining *stack)
+{
+    return !atomic_load_explicit(&stack->lock, memory_order_relaxed) &&
+           !atomic_exchange_explicit(&stack->lock, true, memory_order_acquire);
+}
+
+// Takes the combiner lock, yielding while another thread combines.
+static void stack_fc_lock(StackPoolCombining *stack)
+{
+    while (!stack_fc_try_lock(stack))
+        thrd_yield();
+}
+
+static void stack_fc_unlock(StackPoolCombining *stack)
+{
+    atomic_store_explicit(&stack->lock, false, memory_order_release);
+}
+
+// Serves every posted request, the caller holds the combiner lock.
+static void stack_fc_combine(StackPoolCombining *stack)
+{
+    StFcSlot *pushes[STACK_FC_MAX_SLOTS];
+    StFcSlot *pops[STACK_FC_MAX_SLOTS];
+    size_t push_count = 0;
+    size_t pop_count = 0;
+    StackPool *pool = stack->pool;
+    size_t block_size = pool->block_size;
+    size_t stride = pool->stride;
+    size_t slot_count = atomic_load_explicit(&stack->slot_count, memory_order_relaxed);
+
+    for (size_t i = 0; i < slot_count; ++i)
+    {
+        StFcSlot *slot = &stack->slots[i];
+        int operation = atomic_load_explicit(&slot->operation, memory_order_acquire);
+
+        if (operation == STACK_FC_PUSH)
+            pushes[push_count++] = slot;
+        else if (operation == STACK_FC_POP)
+            pops[pop_count++] = slot;
+    }
+
+    if (!push_count && !pop_count)
+        return;
+
+    // The whole pass is sampled as one operation
+    STACK_TRACE_BEGIN(pool->trace);
+    size_t old_size = pool->size;
+    size_t paired = push_count < pop_count ? push_count : pop_count;
+
+    // A push and a pop of the same pass cancel out without the pool
+    for (size_t i = 0; i < paired; ++i)
+    {
+        StFcSlot *push = pushes[--push_count];
+        StFcSlot *pop = pops[--pop_count];
+
+        pool->copy_block(pop->block, push->block, block_size);
+        push->result = STACK_OK;
+        pop->result = STACK_OK;
+        atomic_store_explicit(&push->operation, STACK_FC_NONE, memory_order_release);
+        atomic_store_explicit(&pop->operation, STACK_FC_NONE, memory_order_release);
+    }
+
+    // The pool is fixed, so the blocks above the top form one run. The
+    // other side of each copy is the buffer of the requesting thread.
+    byte *run = (byte *) pool->pool + pool->size * stride;
+    size_t free_blocks = pool->capacity - pool->size;
+    size_t pushed = push_count < free_blocks ? push_count : free_blocks;
+    size_t popped = pop_count < pool->size ? pop_count : pool->size;
+
+    for (size_t i = 0; i < push_count; ++i)
+    {
+        StFcSlot *slot = pushes[i];
+
+        if (i < pushed)
+        {
+            pool->copy_block(run + i * stride, slot->block, block_size);
+            slot->result = STACK_OK;
+        }
+        else
+            slot->result = STACK_FULL;
+    }
+
+    for (size_t i = 0; i < pop_count; ++i)
+    {
+        StFcSlot *slot = pops[i];
+
+        if (i < popped)
+        {
+            pool->copy_block(slot->block, run - (i + 1) * stride, block_size);
+            slot->result = STACK_OK;
+        }
+        else
+            slot->result = STACK_EMPTY;
+    }
+
+    pool->size = pool->size + pushed - popped;
+    pool->top = (byte *) pool->pool + (pool->size ? pool->size - 1 : 0) * stride;
+
+    // Same accounting as the batch operations of the pool
+    stack_event_update(&pool->event, old_size, pool->size);
+    STACK_STAT_ADD(pool->stats, pushes, paired + pushed);
+    STACK_STAT_ADD(pool->stats, pops, paired + popped);
+    STACK_STAT_ADD(pool->stats, bytes_copied, (paired + pushed + popped) * block_size);
+    STACK_STAT_MAX(pool->stats, high_water, pool->size + pool->spilled);
+    STACK_STAT_ADD(pool->stats, full_rejections, push_count - pushed);
+    STACK_STAT_ADD(pool->stats, empty_rejections, pop_count - popped);
+    STACK_TRACE_END(pool->trace, (paired + push_count) ? STACK_TRACE_PUSH : STACK_TRACE_POP);
+
+    for (size_t i = 0; i < push_count; ++i)
+        atomic_store_explicit(&pushes[i]->operation, STACK_FC_NONE, memory_order_release);
+    for (size_t i = 0; i < pop_count; ++i)
+        atomic_store_explicit(&pops[i]->operation, STACK_FC_NONE, memory_order_release);
+}
+
+// Posts a request and waits until it is served, combining when possible.
+static StackError stack_fc_apply(StackPoolCombining *stack, StFcOperation operation, void *block)
+{
+    StFcSlot *slot = stack_fc_acquire(stack);
+
+    slot->block = block;
+    atomic_store_explicit(&slot->operation, operation, memory_order_release);
+
+    for (;;)
+    {
+        if (stack_fc_try_lock(stack))
+        {
+            stack_fc_combine(stack);
+            stack_fc_unlock(stack);
+        }
+
+        if (atomic_load_explicit(&slot->operation, memory_order_acquire) == STACK_FC_NONE)
+            break;
+        thrd_yield();
+    }
+
+    StackError result = slot->result;
+    atomic_store_explicit(&slot->active, false, memory_order_release);
+    return result;
+}
+
+StackError stack_pool_combining_init(StackPoolCombining **stack, size_t capacity, size_t block_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((capacity == 0) || (block_size == 0))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    StackPoolCombining *new_stack = aligned_alloc(STACK_CACHE_LINE, sizeof(StackPoolCombining));
+    if (!new_stack)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    StackError err = stack_pool_init(&new_stack->pool, capacity, block_size);
+    if (err != STACK_OK)
+    {
+        free(new_stack);
+        STACK_SET_ERROR(err);
+        return err;
+    }
+
+    atomic_init(&new_stack->lock, false);
+    atomic_init(&new_stack->slot_count, 0);
+    for (size_t i = 0; i < STACK_FC_MAX_SLOTS; ++i)
+    {
+        atomic_init(&new_stack->slots[i].operation, STACK_FC_NONE);
+        atomic_init(&new_stack->slots[i].active, false);
+        new_stack->slots[i].block = NULL;
+        new_stack->slots[i].result = STACK_OK;
+    }
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_combining_destroy(StackPoolCombining *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    stack_pool_destroy(stack->pool);
+    free(stack);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_combining_push(StackPoolCombining *stack, const void *data)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!data)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    StackError result = stack_fc_apply(stack, STACK_FC_PUSH, (void *) data);
+    STACK_SET_ERROR(result);
+    return result;
+}
+
+StackError stack_pool_combining_pop(StackPoolCombining *stack, void *out_data)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StackError result = stack_fc_apply(stack, STACK_FC_POP, out_data);
+    STACK_SET_ERROR(result);
+    return result;
+}
+
+StackError stack_pool_combining_size(StackPoolCombining *stack, size_t *out_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_size)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    stack_fc_lock(stack);
+    *out_size = stack->pool->size;
+    stack_fc_unlock(stack);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_combining_event_open(StackPoolCombining *stack, size_t watermark, int *out_fd)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    stack_fc_lock(stack);
+    StackError err = stack_pool_event_open(stack->pool, watermark, out_fd);
+    stack_fc_unlock(stack);
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_combining_event_ack(StackPoolCombining *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    stack_fc_lock(stack);
+    StackError err = stack_pool_event_ack(stack->pool);
+    stack_fc_unlock(stack);
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_combining_event_close(StackPoolCombining *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    stack_fc_lock(stack);
+    StackError err = stack_pool_event_close(stack->pool);
+    stack_fc_unlock(stack);
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_combining_stats(const StackPoolCombining *stack, StackStats *out_stats)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    // The counters are atomics, no need to wait for the combiner
+    return stack_pool_stats(stack->pool, out_stats);
+}
+
+StackError stack_pool_combining_latency(const StackPoolCombining *stack, StackTraceOp op,
+                                        StackLatency *out_latency)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    return stack_pool_latency(stack->pool, op, out_latency);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file stack_pool_internal.h
+ * @brief Helpers shared by the StackPool translation units.
+ */
+
+#ifndef STACK_POOL_INTERNAL_H
+#define STACK_POOL_INTERNAL_H
+
+#include <stack_pool.h>
+
+// Releases the mapping of a pool with mapped storage, syncing a file first.
+void stack_pool_unmap(StackPool *stack);
+
+// Writes the oldest spill_chunk blocks of a full spill pool to its file.
+StackError stack_pool_spill(StackPool *stack);
+
+// Reads the newest spilled chunk back under the blocks in memory (at most one).
+StackError stack_pool_refill(StackPool *stack);
+
+// Closes the spill file of a spill pool.
+void stack_pool_spill_close(StackPool *stack);
+
+// Makes the next step of blocks of a reserved pool accessible.
+StackError stack_pool_commit(StackPool *stack);
+
+// Returns the pages of a reserved pool above the size and the retained blocks.
+void stack_pool_trim(StackPool *stack);
+
+// Registers the counters of a new pool, its memory counts as one allocation.
+static inline void stack_pool_stats_init(StackPool *stack)
+{
+#ifdef STACK_ENABLE_STATS
+    stack_stats_register(&stack->stats, STACK_STATS_POOL, stack);
+    STACK_STAT_ADD(stack->stats, allocations, 1);
+#else
+    (void) stack;
+#endif
+}
+
+#endif // STACK_POOL_INTERNAL_H
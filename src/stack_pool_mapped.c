@@ -0,0 +1,255 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stack_pool.h>
+#include "stack_pool_internal.h"
+
+// Identifies a persistent pool file ("STKPOOL1").
+#define STACK_POOL_MAGIC 0x314c4f4f504b5453ull
+
+// Offset of the second header slot, in another disk sector than the first.
+#define STACK_POOL_HEADER_STRIDE 512
+
+// Offset of the first block in the file.
+#define STACK_POOL_DATA_OFFSET 4096
+
+// Header slot of a persistent pool file.
+typedef struct {
+    uint64_t magic;
+    uint64_t sequence;      // Number of the sync, the valid slot with the highest wins
+    uint64_t block_size;
+    uint64_t capacity;
+    uint64_t size;
+    uint64_t checksum;      // FNV-1a of the fields above
+} StPoolHeader;
+
+static uint64_t stack_pool_header_checksum(const StPoolHeader *header)
+{
+    const byte *bytes = (const byte *) header;
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (size_t i = 0; i < offsetof(StPoolHeader, checksum); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static StPoolHeader *stack_pool_header_slot(void *mapping, uint64_t sequence)
+{
+    return (StPoolHeader *) ((byte *) mapping + (sequence & 1) * STACK_POOL_HEADER_STRIDE);
+}
+
+// Returns the newest intact header slot, NULL when both are damaged.
+static const StPoolHeader *stack_pool_header_current(void *mapping)
+{
+    const StPoolHeader *current = NULL;
+
+    for (uint64_t slot = 0; slot < 2; ++slot)
+    {
+        const StPoolHeader *header = stack_pool_header_slot(mapping, slot);
+
+        if (header->magic == STACK_POOL_MAGIC &&
+            header->checksum == stack_pool_header_checksum(header) &&
+            (!current || header->sequence > current->sequence))
+            current = header;
+    }
+    return current;
+}
+
+// Writes the header of the next sync into the older slot and flushes it.
+static int stack_pool_header_write(StackPool *stack, uint64_t sequence)
+{
+    StPoolHeader header;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = STACK_POOL_MAGIC;
+    header.sequence = sequence;
+    header.block_size = stack->block_size;
+    header.capacity = stack->capacity;
+    header.size = stack->size;
+    header.checksum = stack_pool_header_checksum(&header);
+
+    memcpy(stack_pool_header_slot(stack->mapping, sequence), &header, sizeof(header));
+    return msync(stack->mapping, STACK_POOL_DATA_OFFSET, MS_SYNC);
+}
+
+StackError stack_pool_open(StackPool **stack, const char *path, size_t capacity, size_t block_size)
+{
+    if (!stack || !path)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    StackError err = STACK_ALLOC_FAILED;
+    StackPool *new_stack = calloc(1, sizeof(StackPool));
+    if (!new_stack)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    // A file created by this call is removed again if the call fails
+    bool new_file = true;
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0 && errno == EEXIST)
+    {
+        new_file = false;
+        fd = open(path, O_RDWR);
+    }
+    if (fd < 0)
+        goto open_error;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        goto stat_error;
+
+    bool created = st.st_size == 0;
+    size_t length = (size_t) st.st_size;
+
+    if (created)
+    {
+        if ((capacity == 0) || (block_size == 0) ||
+            (capacity > (SIZE_MAX - STACK_POOL_DATA_OFFSET) / block_size))
+        {
+            err = STACK_INVALID_ARGS;
+            goto stat_error;
+        }
+
+        length = STACK_POOL_DATA_OFFSET + capacity * block_size;
+        if (ftruncate(fd, (off_t) length) != 0)
+            goto stat_error;
+    }
+    else if (length < STACK_POOL_DATA_OFFSET)
+    {
+        err = STACK_INVALID_TYPE;
+        goto stat_error;
+    }
+
+    void *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+        goto stat_error;
+
+    new_stack->mapping = mapping;
+    new_stack->mapping_size = length;
+
+    if (created)
+    {
+        new_stack->block_size = block_size;
+        new_stack->capacity = capacity;
+        new_stack->size = 0;
+        if (stack_pool_header_write(new_stack, 1) != 0)
+            goto header_error;
+    }
+    else
+    {
+        const StPoolHeader *header = stack_pool_header_current(mapping);
+
+        if (!header || header->block_size == 0 ||
+            header->capacity > (length - STACK_POOL_DATA_OFFSET) / header->block_size ||
+            header->size > header->capacity)
+        {
+            err = STACK_INVALID_TYPE;
+            goto header_error;
+        }
+
+        if (block_size && block_size != header->block_size)
+        {
+            err = STACK_INVALID_ARGS;
+            goto header_error;
+        }
+
+        new_stack->block_size = (size_t) header->block_size;
+        new_stack->capacity = (size_t) header->capacity;
+        new_stack->size = (size_t) header->size;
+    }
+    close(fd);
+
+    byte *pool = (byte *) mapping + STACK_POOL_DATA_OFFSET;
+    size_t top = new_stack->size ? new_stack->size - 1 : 0;
+
+    new_stack->pool = pool;
+    new_stack->stride = new_stack->block_size;
+    new_stack->top = pool + top * new_stack->stride;
+    new_stack->base = pool;
+    new_stack->end = pool + new_stack->capacity * new_stack->stride;
+    new_stack->growth = STACK_POOL_FIXED;
+    new_stack->max_capacity = new_stack->capacity;
+    new_stack->copy_block = stack_pool_copy_kernel(new_stack->block_size);
+    stack_event_init(&new_stack->event);
+    new_stack->allocator = stack_allocator_malloc;
+    stack_pool_stats_init(new_stack);
+    new_stack->storage = STACK_POOL_FILE;
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+
+
+    header_error:
+        munmap(mapping, length);
+    stat_error:
+        close(fd);
+        if (new_file)
+            unlink(path);
+    open_error:
+        free(new_stack);
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_sync(StackPool *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (stack->storage != STACK_POOL_FILE)
+    {
+        STACK_SET_ERROR(STACK_INVALID_TYPE);
+        return STACK_INVALID_TYPE;
+    }
+
+    // The blocks must be durable before a header refers to them. msync needs
+    // a page-aligned start, pages larger than the data offset take the
+    // unchanged headers along.
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    size_t start = STACK_POOL_DATA_OFFSET / page_size * page_size;
+    if (msync((byte *) stack->mapping + start, stack->mapping_size - start, MS_SYNC) != 0)
+    {
+        STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+        return STACK_UNKNOWN_ERROR;
+    }
+
+    const StPoolHeader *current = stack_pool_header_current(stack->mapping);
+    uint64_t sequence = current ? current->sequence + 1 : 1;
+
+    if (stack_pool_header_write(stack, sequence) != 0)
+    {
+        STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+        return STACK_UNKNOWN_ERROR;
+    }
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+void stack_pool_unmap(StackPool *stack)
+{
+    if (stack->storage == STACK_POOL_FILE)
+        stack_pool_sync(stack);
+    munmap(stack->mapping, stack->mapping_size);
+}
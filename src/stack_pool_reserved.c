@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <stack_pool.h>
+#include "stack_pool_internal.h"
+
+// Number of bytes committed at once as the stack grows.
+#define STACK_POOL_COMMIT_STEP (64 * 1024)
+
+#ifdef MAP_NORESERVE
+#define STACK_POOL_RESERVE_FLAGS (MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE)
+#else
+#define STACK_POOL_RESERVE_FLAGS (MAP_PRIVATE | MAP_ANONYMOUS)
+#endif
+
+static size_t stack_pool_page_size(void)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t) page : 4096;
+}
+
+static size_t stack_pool_page_round(size_t bytes, size_t page)
+{
+    return (bytes + page - 1) / page * page;
+}
+
+// Number of blocks committed by one step.
+static size_t stack_pool_commit_blocks(const StackPool *stack)
+{
+    size_t blocks = STACK_POOL_COMMIT_STEP / stack->stride;
+    return blocks ? blocks : 1;
+}
+
+// Makes the pages holding blocks [from, to) accessible.
+static int stack_pool_protect(StackPool *stack, size_t from, size_t to, int prot)
+{
+    size_t page = stack_pool_page_size();
+    size_t start = from * stack->stride / page * page;
+    size_t end = stack_pool_page_round(to * stack->stride, page);
+
+    return mprotect((byte *) stack->pool + start, end - start, prot);
+}
+
+StackError stack_pool_init_reserved(StackPool **stack, size_t capacity, size_t block_size,
+                                    size_t retain)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    size_t page = stack_pool_page_size();
+
+    if ((capacity == 0) || (block_size == 0) || (capacity > (SIZE_MAX - 2 * page) / block_size))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    StackPool *new_stack = calloc(1, sizeof(StackPool));
+    if (!new_stack)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    // The page after the last block is never made accessible
+    size_t length = stack_pool_page_round(capacity * block_size, page) + page;
+    void *mapping = mmap(NULL, length, PROT_NONE, STACK_POOL_RESERVE_FLAGS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        free(new_stack);
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    new_stack->pool = mapping;
+    new_stack->top = mapping;
+    new_stack->capacity = capacity;
+    new_stack->block_size = block_size;
+    new_stack->stride = block_size;
+    new_stack->size = 0;
+    new_stack->base = mapping;
+    new_stack->end = mapping;
+    new_stack->growth = STACK_POOL_FIXED;
+    new_stack->max_capacity = capacity;
+    new_stack->copy_block = stack_pool_copy_kernel(block_size);
+    stack_event_init(&new_stack->event);
+    new_stack->allocator = stack_allocator_malloc;
+    new_stack->storage = STACK_POOL_RESERVED;
+    new_stack->mapping = mapping;
+    new_stack->mapping_size = length;
+    new_stack->retain = retain < capacity ? retain : capacity;
+
+    if (stack_pool_commit(new_stack) != STACK_OK)
+    {
+        munmap(mapping, length);
+        free(new_stack);
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+    stack_pool_stats_init(new_stack);
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_commit(StackPool *stack)
+{
+    size_t committed = ((byte *) stack->end - (byte *) stack->pool) / stack->stride;
+    size_t blocks = stack_pool_commit_blocks(stack);
+
+    if (blocks > stack->capacity - committed)
+        blocks = stack->capacity - committed;
+
+    if (stack_pool_protect(stack, committed, committed + blocks, PROT_READ | PROT_WRITE) != 0)
+        return STACK_ALLOC_FAILED;
+
+    stack->end = (byte *) stack->end + blocks * stack->stride;
+    return STACK_OK;
+}
+
+void stack_pool_trim(StackPool *stack)
+{
+    size_t committed = ((byte *) stack->end - (byte *) stack->pool) / stack->stride;
+    size_t step = stack_pool_commit_blocks(stack);
+    size_t used = stack->size > stack->retain ? stack->size : stack->retain;
+
+    // One spare step is kept, so a stack moving around a step boundary does not thrash
+    size_t keep = (used / step + 2) * step;
+    if (keep >= committed)
+        return;
+
+    size_t page = stack_pool_page_size();
+    size_t start = stack_pool_page_round(keep * stack->stride, page);
+    size_t end = stack_pool_page_round(committed * stack->stride, page);
+
+    if (start < end)
+    {
+        byte *release = (byte *) stack->pool + start;
+        madvise(release, end - start, MADV_DONTNEED);
+        mprotect(release, end - start, PROT_NONE);
+    }
+
+    stack->end = (byte *) stack->pool + keep * stack->stride;
+}
@@ -0,0 +1,334 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stack_pool_shared.h>
+
+// Marks an initialized shared stack ("STKSHRD1").
+#define STACK_SHARED_MAGIC 0x314452485348544bull
+
+// Blocks start at a cache line boundary after the header.
+#define STACK_SHARED_ALIGN 64
+
+// Takes the lock, recovering it from a process that died holding it.
+static StackError stack_shared_lock(StSharedHeader *header)
+{
+    int rc = pthread_mutex_lock(&header->lock);
+
+    if (rc == EOWNERDEAD)
+    {
+        // Sizes change only after a complete copy, the stack is consistent
+        ++header->owner_deaths;
+        rc = pthread_mutex_consistent(&header->lock);
+
+        // This process owns the lock now and must release it even on failure.
+        // A robust mutex unlocked without being made consistent becomes
+        // permanently unusable (ENOTRECOVERABLE), but the other processes
+        // get an error instead of blocking forever.
+        if (rc != 0)
+            pthread_mutex_unlock(&header->lock);
+    }
+
+    return rc == 0 ? STACK_OK : STACK_UNKNOWN_ERROR;
+}
+
+// Creates a handle for a mapped stack.
+static StackPoolShared *stack_shared_handle(StSharedHeader *header, size_t mapping_size)
+{
+    StackPoolShared *stack = malloc(sizeof(StackPoolShared));
+    if (!stack)
+        return NULL;
+
+    stack->header = header;
+    stack->blocks = (byte *) header + header->data_offset;
+    stack->mapping_size = mapping_size;
+    stack->copy_block = stack_pool_copy_kernel((size_t) header->block_size);
+    return stack;
+}
+
+StackError stack_pool_shared_create(StackPoolShared **stack, const char *name,
+                                    size_t capacity, size_t block_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    size_t data_offset = (sizeof(StSharedHeader) + STACK_SHARED_ALIGN - 1) &
+                         ~(size_t) (STACK_SHARED_ALIGN - 1);
+
+    if ((capacity == 0) || (block_size == 0) ||
+        (capacity > (SIZE_MAX - data_offset) / block_size))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    size_t length = data_offset + capacity * block_size;
+    void *mapping = MAP_FAILED;
+
+    if (name)
+    {
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+            goto mapping_error;
+
+        if (ftruncate(fd, (off_t) length) == 0)
+            mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mapping == MAP_FAILED)
+        {
+            shm_unlink(name);
+            goto mapping_error;
+        }
+    }
+    else
+    {
+        mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+            goto mapping_error;
+    }
+
+    StSharedHeader *header = mapping;
+    pthread_mutexattr_t attr;
+
+    if (pthread_mutexattr_init(&attr) != 0)
+        goto lock_error;
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int rc = pthread_mutex_init(&header->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (rc != 0)
+        goto lock_error;
+
+    header->block_size = block_size;
+    header->capacity = capacity;
+    header->size = 0;
+    header->data_offset = data_offset;
+    header->owner_deaths = 0;
+
+    StackPoolShared *new_stack = stack_shared_handle(header, length);
+    if (!new_stack)
+        goto handle_error;
+
+    // Attaching processes see a complete header once the magic is set
+    atomic_store_explicit(&header->magic, STACK_SHARED_MAGIC, memory_order_release);
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+
+
+    handle_error:
+        pthread_mutex_destroy(&header->lock);
+    lock_error:
+        munmap(mapping, length);
+        if (name)
+            shm_unlink(name);
+    mapping_error:
+
+    STACK_SET_ERROR(STACK_ALLOC_FAILED);
+    return STACK_ALLOC_FAILED;
+}
+
+StackError stack_pool_shared_attach(StackPoolShared **stack, const char *name)
+{
+    if (!stack || !name)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    StackError err = STACK_ALLOC_FAILED;
+    struct stat st;
+    void *mapping = MAP_FAILED;
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    if (fstat(fd, &st) == 0)
+    {
+        if ((size_t) st.st_size < sizeof(StSharedHeader))
+            err = STACK_INVALID_TYPE;
+        else
+            mapping = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        STACK_SET_ERROR(err);
+        return err;
+    }
+
+    StSharedHeader *header = mapping;
+    size_t length = (size_t) st.st_size;
+
+    if (atomic_load_explicit(&header->magic, memory_order_acquire) != STACK_SHARED_MAGIC ||
+        header->block_size == 0 || header->data_offset > length ||
+        header->capacity > (length - header->data_offset) / header->block_size)
+    {
+        munmap(mapping, length);
+        STACK_SET_ERROR(STACK_INVALID_TYPE);
+        return STACK_INVALID_TYPE;
+    }
+
+    StackPoolShared *new_stack = stack_shared_handle(header, length);
+    if (!new_stack)
+    {
+        munmap(mapping, length);
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_shared_detach(StackPoolShared *stack)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    munmap(stack->header, stack->mapping_size);
+    free(stack);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_shared_unlink(const char *name)
+{
+    if (!name)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (shm_unlink(name) != 0)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_shared_push(StackPoolShared *stack, const void *data)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!data)
+    {
+        STACK_SET_ERROR(STACK_NULL_DATA);
+        return STACK_NULL_DATA;
+    }
+
+    StSharedHeader *header = stack->header;
+    StackError err = stack_shared_lock(header);
+    if (err != STACK_OK)
+    {
+        STACK_SET_ERROR(err);
+        return err;
+    }
+
+    if (header->size == header->capacity)
+        err = STACK_FULL;
+    else
+    {
+        size_t block_size = (size_t) header->block_size;
+        stack->copy_block(stack->blocks + header->size * block_size, data, block_size);
+        ++header->size;
+    }
+
+    pthread_mutex_unlock(&header->lock);
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_shared_pop(StackPoolShared *stack, void *out_data)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_data)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StSharedHeader *header = stack->header;
+    StackError err = stack_shared_lock(header);
+    if (err != STACK_OK)
+    {
+        STACK_SET_ERROR(err);
+        return err;
+    }
+
+    if (header->size == 0)
+        err = STACK_EMPTY;
+    else
+    {
+        size_t block_size = (size_t) header->block_size;
+        stack->copy_block(out_data, stack->blocks + (header->size - 1) * block_size, block_size);
+        --header->size;
+    }
+
+    pthread_mutex_unlock(&header->lock);
+
+    STACK_SET_ERROR(err);
+    return err;
+}
+
+StackError stack_pool_shared_size(StackPoolShared *stack, size_t *out_size)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (!out_size)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+    StackError err = stack_shared_lock(stack->header);
+    if (err != STACK_OK)
+    {
+        STACK_SET_ERROR(err);
+        return err;
+    }
+
+    *out_size = (size_t) stack->header->size;
+    pthread_mutex_unlock(&stack->header->lock);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stack_pool.h>
+#include "stack_pool_internal.h"
+
+// Name of the temporary file, the X are replaced by mkstemp().
+#define STACK_POOL_SPILL_NAME "stack_pool_spill.XXXXXX"
+
+// Writes the whole buffer at offset, retrying short and interrupted writes.
+static int stack_pool_spill_write(int fd, const byte *buffer, size_t length, off_t offset)
+{
+    while (length)
+    {
+        ssize_t written = pwrite(fd, buffer, length, offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+
+        buffer += written;
+        length -= (size_t) written;
+        offset += written;
+    }
+
+    return 0;
+}
+
+// Reads the whole buffer from offset, retrying short and interrupted reads.
+static int stack_pool_spill_read(int fd, byte *buffer, size_t length, off_t offset)
+{
+    while (length)
+    {
+        ssize_t got = pread(fd, buffer, length, offset);
+        if (got <= 0)
+        {
+            if (got < 0 && errno == EINTR)
+                continue;
+            return -1;
+        }
+
+        buffer += got;
+        length -= (size_t) got;
+        offset += got;
+    }
+
+    return 0;
+}
+
+StackError stack_pool_init_spill(StackPool **stack, size_t capacity, size_t block_size,
+                                 const char *dir)
+{
+    if (!stack)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if ((capacity < 2) || (block_size == 0) || (capacity > SIZE_MAX / block_size))
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+    if (!dir)
+        dir = getenv("TMPDIR");
+    if (!dir || !*dir)
+        dir = "/tmp";
+
+    size_t path_size = strlen(dir) + sizeof("/" STACK_POOL_SPILL_NAME);
+    char *path = malloc(path_size);
+    if (!path)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+    snprintf(path, path_size, "%s/" STACK_POOL_SPILL_NAME, dir);
+
+    // The file is only reachable through the descriptor, it goes away with it
+    int fd = mkstemp(path);
+    if (fd >= 0)
+        unlink(path);
+    free(path);
+
+    if (fd < 0)
+    {
+        STACK_SET_ERROR(STACK_ALLOC_FAILED);
+        return STACK_ALLOC_FAILED;
+    }
+
+    StackPool *new_stack = NULL;
+    StackError err = stack_pool_init(&new_stack, capacity, block_size);
+    if (err != STACK_OK)
+    {
+        close(fd);
+        STACK_SET_ERROR(err);
+        return err;
+    }
+
+    new_stack->growth = STACK_POOL_SPILL;
+    new_stack->spill_fd = fd;
+    new_stack->spilled = 0;
+    new_stack->spill_chunk = capacity / 2;
+    *stack = new_stack;
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+}
+
+StackError stack_pool_spill(StackPool *stack)
+{
+    byte *pool = stack->pool;
+    size_t chunk = stack->spill_chunk;
+    size_t length = chunk * stack->stride;
+
+    if (stack_pool_spill_write(stack->spill_fd, pool, length,
+                               (off_t) (stack->spilled * stack->stride)) != 0)
+        return STACK_ALLOC_FAILED;
+
+    stack->size -= chunk;
+    stack->spilled += chunk;
+    memmove(pool, pool + length, stack->size * stack->stride);
+    stack->top = pool + (stack->size ? stack->size - 1 : 0) * stack->stride;
+
+    return STACK_OK;
+}
+
+StackError stack_pool_refill(StackPool *stack)
+{
+    byte *pool = stack->pool;
+    size_t chunk = stack->spilled < stack->spill_chunk ? stack->spilled : stack->spill_chunk;
+    size_t length = chunk * stack->stride;
+    off_t offset = (off_t) ((stack->spilled - chunk) * stack->stride);
+
+    memmove(pool + length, pool, stack->size * stack->stride);
+    if (stack_pool_spill_read(stack->spill_fd, pool, length, offset) != 0)
+    {
+        memmove(pool, pool + length, stack->size * stack->stride);
+        return STACK_UNKNOWN_ERROR;
+    }
+
+    stack->spilled -= chunk;
+    stack->size += chunk;
+    stack->top = pool + (stack->size - 1) * stack->stride;
+
+    // Starts reading the next chunk while the refilled blocks are popped
+    if (stack->spilled)
+    {
+        size_t next = stack->spilled < stack->spill_chunk ? stack->spilled : stack->spill_chunk;
+        posix_fadvise(stack->spill_fd, (off_t) ((stack->spilled - next) * stack->stride),
+                      (off_t) (next * stack->stride), POSIX_FADV_WILLNEED);
+    }
+
+    return STACK_OK;
+}
+
+void stack_pool_spill_close(StackPool *stack)
+{
+    close(stack->spill_fd);
+    stack->spilled = 0;
+}
@@ -0,0 +1,168 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stack_stats.h>
+
+#ifdef STACK_ENABLE_STATS
+
+#include <stdatomic.h>
+
+// Registry of live stacks, taken only at init, destroy and dump
+static StStackCounters *registry;
+static atomic_flag registry_lock = ATOMIC_FLAG_INIT;
+
+// Row of a dump, copied out of the registry
+typedef struct {
+    StackStats stats;
+    StStatsKind kind;
+    const void *id;
+} StStatsRow;
+
+static void stack_stats_lock(void)
+{
+    while (atomic_flag_test_and_set_explicit(&registry_lock, memory_order_acquire))
+        ;
+}
+
+static void stack_stats_unlock(void)
+{
+    atomic_flag_clear_explicit(&registry_lock, memory_order_release);
+}
+
+void stack_stats_register(StStackCounters *counters, StStatsKind kind, const void *owner)
+{
+    atomic_init(&counters->pushes, 0);
+    atomic_init(&counters->pops, 0);
+    atomic_init(&counters->high_water, 0);
+    atomic_init(&counters->full_rejections, 0);
+    atomic_init(&counters->empty_rejections, 0);
+    atomic_init(&counters->bytes_copied, 0);
+    atomic_init(&counters->allocations, 0);
+    counters->kind = kind;
+    counters->owner = owner;
+    counters->prev = NULL;
+
+    stack_stats_lock();
+    counters->next = registry;
+    if (registry)
+        registry->prev = counters;
+    registry = counters;
+    stack_stats_unlock();
+}
+
+void stack_stats_unregister(StStackCounters *counters)
+{
+    stack_stats_lock();
+    if (counters->prev)
+        counters->prev->next = counters->next;
+    else
+        registry = counters->next;
+    if (counters->next)
+        counters->next->prev = counters->prev;
+    stack_stats_unlock();
+}
+
+void stack_stats_read(const StStackCounters *counters, StackStats *out_stats)
+{
+    out_stats->pushes = atomic_load_explicit(&counters->pushes, memory_order_relaxed);
+    out_stats->pops = atomic_load_explicit(&counters->pops, memory_order_relaxed);
+    out_stats->high_water = atomic_load_explicit(&counters->high_water, memory_order_relaxed);
+    out_stats->full_rejections = atomic_load_explicit(&counters->full_rejections,
+                                                      memory_order_relaxed);
+    out_stats->empty_rejections = atomic_load_explicit(&counters->empty_rejections,
+                                                       memory_order_relaxed);
+    out_stats->bytes_copied = atomic_load_explicit(&counters->bytes_copied, memory_order_relaxed);
+    out_stats->allocations = atomic_load_explicit(&counters->allocations, memory_order_relaxed);
+}
+
+// Copies up to capacity rows under the lock, returns the number of live stacks.
+static size_t stack_stats_snapshot(StStatsRow *rows, size_t capacity)
+{
+    size_t count = 0;
+
+    stack_stats_lock();
+    for (const StStackCounters *counters = registry; counters; counters = counters->next)
+    {
+        if (count < capacity)
+        {
+            stack_stats_read(counters, &rows[count].stats);
+            rows[count].kind = counters->kind;
+            rows[count].id = counters->owner;
+        }
+        ++count;
+    }
+    stack_stats_unlock();
+
+    return count;
+}
+
+#endif // STACK_ENABLE_STATS
+
+StackError stack_stats_dump(FILE *out, StackStatsFormat format)
+{
+    if (!out)
+    {
+        STACK_SET_ERROR(STACK_NULL_PTR);
+        return STACK_NULL_PTR;
+    }
+
+    if (format != STACK_STATS_TEXT && format != STACK_STATS_JSON)
+    {
+        STACK_SET_ERROR(STACK_INVALID_ARGS);
+        return STACK_INVALID_ARGS;
+    }
+
+#ifdef STACK_ENABLE_STATS
+    // The stream may block, so the rows are formatted after the lock is released
+    StStatsRow *rows = NULL;
+    size_t capacity = 0;
+    size_t count = stack_stats_snapshot(rows, capacity);
+
+    while (count > capacity)
+    {
+        // Room for stacks created while the buffer is allocated
+        capacity = count + count / 2 + 8;
+        free(rows);
+        rows = malloc(capacity * sizeof(StStatsRow));
+        if (!rows)
+        {
+            STACK_SET_ERROR(STACK_ALLOC_FAILED);
+            return STACK_ALLOC_FAILED;
+        }
+        count = stack_stats_snapshot(rows, capacity);
+    }
+
+    if (format == STACK_STATS_JSON)
+        fputs("[", out);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const StackStats *stats = &rows[i].stats;
+        const char *kind = rows[i].kind == STACK_STATS_POOL ? "pool" : "dyn";
+
+        if (format == STACK_STATS_JSON)
+            fprintf(out, "%s\n  {\"kind\": \"%s\", \"id\": \"%p\", \"pushes\": %zu, "
+                    "\"pops\": %zu, \"high_water\": %zu, \"full_rejections\": %zu, "
+                    "\"empty_rejections\": %zu, \"bytes_copied\": %zu, \"allocations\": %zu}",
+                    i == 0 ? "" : ",", kind, rows[i].id,
+                    stats->pushes, stats->pops, stats->high_water, stats->full_rejections,
+                    stats->empty_rejections, stats->bytes_copied, stats->allocations);
+        else
+            fprintf(out, "kind=%s id=%p pushes=%zu pops=%zu high_water=%zu "
+                    "full_rejections=%zu empty_rejections=%zu bytes_copied=%zu "
+                    "allocations=%zu\n", kind, rows[i].id, stats->pushes,
+                    stats->pops, stats->high_water, stats->full_rejections,
+                    stats->empty_rejections, stats->bytes_copied, stats->allocations);
+    }
+
+    if (format == STACK_STATS_JSON)
+        fputs("\n]\n", out);
+    free(rows);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+#else
+    STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+    return STACK_UNKNOWN_ERROR;
+#endif
+}
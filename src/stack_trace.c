@@ -0,0 +1,149 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+#include <stack_trace.h>
+
+#ifdef STACK_ENABLE_TRACE
+
+atomic_size_t stack_trace_rate;
+
+uint64_t stack_trace_now(void)
+{
+    // CLOCK_MONOTONIC is served from the vDSO without a system call
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+// Index of the bucket holding value.
+static size_t stack_trace_bucket(uint64_t value)
+{
+    if (value < (1u << STACK_TRACE_SUB_BITS))
+        return (size_t) value;
+
+    unsigned exponent = 63 - (unsigned) __builtin_clzll(value);
+    unsigned shift = exponent - STACK_TRACE_SUB_BITS;
+    size_t sub = (size_t) (value >> shift) & ((1u << STACK_TRACE_SUB_BITS) - 1);
+
+    return ((size_t) (shift + 1) << STACK_TRACE_SUB_BITS) + sub;
+}
+
+// Largest value falling into the bucket.
+static uint64_t stack_trace_bucket_max(size_t bucket)
+{
+    if (bucket < (1u << STACK_TRACE_SUB_BITS))
+        return bucket;
+
+    unsigned shift = (unsigned) (bucket >> STACK_TRACE_SUB_BITS) - 1;
+    uint64_t sub = bucket & ((1u << STACK_TRACE_SUB_BITS) - 1);
+    uint64_t low = (((uint64_t) 1 << STACK_TRACE_SUB_BITS) + sub) << shift;
+
+    return low + (((uint64_t) 1 << shift) - 1);
+}
+
+void stack_trace_record(StStackTrace *trace, StackTraceOp op, uint64_t start)
+{
+    uint64_t end = stack_trace_now();
+    StTraceHistogram *histograms = atomic_load_explicit(&trace->histograms, memory_order_relaxed);
+
+    if (!histograms)
+    {
+        // The sample is lost if there is no memory for the histograms
+        histograms = calloc(STACK_TRACE_OPS, sizeof(StTraceHistogram));
+        if (!histograms)
+            return;
+        atomic_store_explicit(&trace->histograms, histograms, memory_order_release);
+    }
+
+    // Only the thread operating the stack writes the counts
+    atomic_size_t *count = &histograms[op].counts[stack_trace_bucket(end - start)];
+    atomic_store_explicit(count, atomic_load_explicit(count, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+}
+
+void stack_trace_close(StStackTrace *trace)
+{
+    free(atomic_load_explicit(&trace->histograms, memory_order_relaxed));
+    atomic_store_explicit(&trace->histograms, NULL, memory_order_relaxed);
+}
+
+void stack_trace_read(const StStackTrace *trace, StackTraceOp op, StackLatency *out_latency)
+{
+    StackLatency latency = {0};
+    size_t counts[STACK_TRACE_BUCKETS];
+    StTraceHistogram *histograms = atomic_load_explicit(&trace->histograms,
+                                                        memory_order_acquire);
+
+    if (!histograms)
+    {
+        *out_latency = latency;
+        return;
+    }
+
+    for (size_t i = 0; i < STACK_TRACE_BUCKETS; ++i)
+    {
+        counts[i] = atomic_load_explicit(&histograms[op].counts[i], memory_order_relaxed);
+        latency.samples += counts[i];
+    }
+
+    // Ranks of the percentiles, rounded up
+    size_t p50 = (latency.samples * 500 + 999) / 1000;
+    size_t p99 = (latency.samples * 990 + 999) / 1000;
+    size_t p999 = (latency.samples * 999 + 999) / 1000;
+    size_t seen = 0;
+
+    for (size_t i = 0; i < STACK_TRACE_BUCKETS; ++i)
+    {
+        if (!counts[i])
+            continue;
+
+        uint64_t value = stack_trace_bucket_max(i);
+        if (seen < p50 && seen + counts[i] >= p50)
+            latency.p50 = value;
+        if (seen < p99 && seen + counts[i] >= p99)
+            latency.p99 = value;
+        if (seen < p999 && seen + counts[i] >= p999)
+            latency.p999 = value;
+        latency.max = value;
+        seen += counts[i];
+    }
+
+    *out_latency = latency;
+}
+
+#endif // STACK_ENABLE_TRACE
+
+StackError stack_trace_set_rate(size_t rate)
+{
+#ifdef STACK_ENABLE_TRACE
+    atomic_store_explicit(&stack_trace_rate, rate, memory_order_relaxed);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+#else
+    (void) rate;
+    STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+    return STACK_UNKNOWN_ERROR;
+#endif
+}
+
+StackError stack_trace_get_rate(size_t *out_rate)
+{
+    if (!out_rate)
+    {
+        STACK_SET_ERROR(STACK_NULL_OUT);
+        return STACK_NULL_OUT;
+    }
+
+#ifdef STACK_ENABLE_TRACE
+    *out_rate = atomic_load_explicit(&stack_trace_rate, memory_order_relaxed);
+
+    STACK_SET_ERROR(STACK_OK);
+    return STACK_OK;
+#else
+    STACK_SET_ERROR(STACK_UNKNOWN_ERROR);
+    return STACK_UNKNOWN_ERROR;
+#endif
+}
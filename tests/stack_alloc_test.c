@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+#include <stack_alloc.h>
+#include <stack_pool.h>
+#include <stack_dyn.h>
+
+// Allocator counting the calls and the bytes held, backed by malloc
+typedef struct {
+    size_t allocs;
+    size_t frees;
+    size_t bytes;
+    size_t fail_after;   // Allocations left before alloc fails, SIZE_MAX for never
+} CountingCtx;
+
+static void* counting_alloc(void* ctx, size_t size) {
+    CountingCtx* counts = ctx;
+    if (counts->fail_after == 0)
+        return NULL;
+    if (counts->fail_after != SIZE_MAX)
+        counts->fail_after--;
+    counts->allocs++;
+    counts->bytes += size;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    CountingCtx* counts = ctx;
+    void* moved = realloc(ptr, new_size);
+    if (moved)
+        counts->bytes = counts->bytes - old_size + new_size;
+    return moved;
+}
+
+static void counting_free(void* ctx, void* ptr, size_t size) {
+    CountingCtx* counts = ctx;
+    if (!ptr)
+        return;
+    counts->frees++;
+    counts->bytes -= size;
+    free(ptr);
+}
+
+void test_stack_arena() {
+    printf("Testing stack_arena...\n");
+    
+    StackArena arena;
+    StackAllocator allocator;
+    
+    assert(stack_arena_init(NULL, 64) == STACK_NULL_PTR);
+    assert(stack_arena_init(&arena, 0) == STACK_INVALID_ARGS);
+    assert(stack_arena_init(&arena, 256) == STACK_OK);
+    assert(stack_arena_allocator(NULL, &allocator) == STACK_NULL_PTR);
+    assert(stack_arena_allocator(&arena, NULL) == STACK_NULL_OUT);
+    assert(stack_arena_allocator(&arena, &allocator) == STACK_OK);
+    
+    // Allocations are aligned for any type and follow each other
+    char* a = allocator.alloc(allocator.ctx, 3);
+    char* b = allocator.alloc(allocator.ctx, 40);
+    assert(a && b);
+    assert((uintptr_t)a % _Alignof(max_align_t) == 0);
+    assert((uintptr_t)b % _Alignof(max_align_t) == 0);
+    assert(b > a && b - a < 64);
+    memset(b, 'x', 40);
+    
+    // The latest allocation grows in place, an older one is copied
+    assert(allocator.realloc(allocator.ctx, b, 40, 80) == b);
+    char* c = allocator.realloc(allocator.ctx, a, 3, 8);
+    assert(c && c != a);
+    assert(allocator.realloc(allocator.ctx, c, 8, 1000) != c);
+    allocator.free(allocator.ctx, b, 80);
+    
+    // A request larger than a block gets its own block
+    char* big = allocator.alloc(allocator.ctx, 4096);
+    assert(big != NULL);
+    memset(big, 0, 4096);
+    
+    assert(stack_arena_reset(&arena) == STACK_OK);
+    assert(arena.block != NULL && arena.block->prev == NULL);
+    assert(allocator.alloc(allocator.ctx, 16) != NULL);
+    
+    assert(stack_arena_destroy(&arena) == STACK_OK);
+    assert(arena.block == NULL);
+    assert(stack_arena_reset(NULL) == STACK_NULL_PTR);
+    assert(stack_arena_destroy(NULL) == STACK_NULL_PTR);
+    
+    printf("stack_arena tests passed!\n\n");
+}
+
+void test_stack_alloc_pool() {
+    printf("Testing stack_pool_init_allocator...\n");
+    
+    CountingCtx counts = {0, 0, 0, SIZE_MAX};
+    StackAllocator allocator = {counting_alloc, counting_realloc, counting_free, &counts};
+    StackAllocator incomplete = {counting_alloc, NULL, counting_free, &counts};
+    StackPool* stack = NULL;
+    int value = 0;
+    
+    assert(stack_pool_init_allocator(NULL, 4, sizeof(int), STACK_POOL_FIXED, 4, &allocator) == STACK_NULL_PTR);
+    assert(stack_pool_init_allocator(&stack, 4, sizeof(int), STACK_POOL_FIXED, 4, NULL) == STACK_NULL_PTR);
+    assert(stack_pool_init_allocator(&stack, 4, sizeof(int), STACK_POOL_FIXED, 4, &incomplete) == STACK_INVALID_ARGS);
+    
+    // Every growth policy returns all bytes it took
+    StackPoolGrowth policies[] = {STACK_POOL_FIXED, STACK_POOL_DOUBLE, STACK_POOL_SEGMENTED};
+    for (size_t p = 0; p < 3; p++) {
+        assert(stack_pool_init_allocator(&stack, 4, sizeof(int), policies[p], 64, &allocator) == STACK_OK);
+        int pushes = policies[p] == STACK_POOL_FIXED ? 4 : 50;
+        for (int i = 0; i < pushes; i++)
+            assert(stack_pool_push(stack, &i) == STACK_OK);
+        for (int i = pushes - 1; i >= 0; i--) {
+            assert(stack_pool_pop(stack, &value) == STACK_OK);
+            assert(value == i);
+        }
+        assert(counts.bytes > 0);
+        assert(stack_pool_destroy(stack) == STACK_OK);
+        assert(counts.bytes == 0);
+        assert(counts.allocs == counts.frees);
+    }
+    
+    // Failed allocations leave nothing behind
+    for (size_t fail = 0; fail < 3; fail++) {
+        counts.fail_after = fail;
+        StackError err = stack_pool_init_allocator(&stack, 4, sizeof(int), STACK_POOL_SEGMENTED, 64,
+                                                   &allocator);
+        if (err == STACK_OK) {
+            assert(stack_pool_push_n(stack, &value, 1, NULL) == STACK_OK);
+            stack_pool_destroy(stack);
+        } else {
+            assert(err == STACK_ALLOC_FAILED);
+        }
+        assert(counts.bytes == 0);
+    }
+    counts.fail_after = SIZE_MAX;
+    
+    // A growing stack in an arena
+    StackArena arena;
+    assert(stack_arena_init(&arena, 1024) == STACK_OK);
+    assert(stack_arena_allocator(&arena, &allocator) == STACK_OK);
+    assert(stack_pool_init_allocator(&stack, 2, sizeof(int), STACK_POOL_DOUBLE, 0, &allocator) == STACK_OK);
+    for (int i = 0; i < 1000; i++)
+        assert(stack_pool_push(stack, &i) == STACK_OK);
+    for (int i = 999; i >= 0; i--) {
+        assert(stack_pool_pop(stack, &value) == STACK_OK);
+        assert(value == i);
+    }
+    // Destroying frees nothing, the arena returns the memory at once
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    assert(arena.block != NULL);
+    assert(stack_arena_destroy(&arena) == STACK_OK);
+    
+    printf("stack_pool_init_allocator tests passed!\n\n");
+}
+
+void test_stack_alloc_dyn() {
+    printf("Testing stack_dyn_init_allocator...\n");
+    
+    CountingCtx counts = {0, 0, 0, SIZE_MAX};
+    StackAllocator allocator = {counting_alloc, counting_realloc, counting_free, &counts};
+    StackDyn* stack = NULL;
+    int values[600];
+    void* out = NULL;
+    
+    assert(stack_dyn_init_allocator(NULL, NULL, NULL, false, &allocator) == STACK_NULL_PTR);
+    assert(stack_dyn_init_allocator(&stack, NULL, NULL, false, NULL) == STACK_NULL_PTR);
+    assert(stack_dyn_init_allocator(&stack, NULL, free, false, &allocator) == STACK_INVALID_ARGS);
+    
+    for (int chunked = 0; chunked < 2; chunked++) {
+        assert(stack_dyn_init_allocator(&stack, NULL, NULL, chunked, &allocator) == STACK_OK);
+        assert(stack->chunked == (chunked != 0));
+        for (int i = 0; i < 600; i++)
+            assert(stack_dyn_push(stack, &values[i]) == STACK_OK);
+        for (int i = 599; i >= 300; i--) {
+            assert(stack_dyn_pop(stack, &out) == STACK_OK);
+            assert(out == &values[i]);
+        }
+        assert(counts.allocs > 2);
+        assert(stack_dyn_clear(stack) == STACK_OK);
+        assert(stack_dyn_push(stack, &values[0]) == STACK_OK);
+        assert(stack_dyn_destroy(stack) == STACK_OK);
+        assert(counts.bytes == 0);
+        assert(counts.allocs == counts.frees);
+    }
+    
+    // Request-scoped stacks in an arena, released at once
+    StackArena arena;
+    assert(stack_arena_init(&arena, 4096) == STACK_OK);
+    assert(stack_arena_allocator(&arena, &allocator) == STACK_OK);
+    for (int request = 0; request < 3; request++) {
+        assert(stack_dyn_init_allocator(&stack, NULL, NULL, request % 2, &allocator) == STACK_OK);
+        for (int i = 0; i < 600; i++)
+            assert(stack_dyn_push(stack, &values[i]) == STACK_OK);
+        assert(stack_dyn_pop(stack, &out) == STACK_OK);
+        assert(out == &values[599]);
+        assert(stack_dyn_destroy(stack) == STACK_OK);
+        assert(stack_arena_reset(&arena) == STACK_OK);
+    }
+    assert(stack_arena_destroy(&arena) == STACK_OK);
+    
+    printf("stack_dyn_init_allocator tests passed!\n\n");
+}
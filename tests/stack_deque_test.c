@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stack_deque.h>
+
+#define STRESS_THIEVES 4
+#define STRESS_VALUES  100000
+
+typedef struct {
+    int id;
+    char name[16];
+} TestItem;
+
+void test_stack_deque_init() {
+    printf("Testing stack_deque_init...\n");
+    
+    StackDeque* deque = NULL;
+    size_t size = 1;
+    
+    assert(stack_deque_init(&deque, 5, sizeof(int)) == STACK_OK);
+    assert(deque != NULL);
+    assert(atomic_load(&deque->buffer)->capacity == 8);
+    assert(deque->block_size == sizeof(int));
+    assert(stack_deque_size(deque, &size) == STACK_OK);
+    assert(size == 0);
+    stack_deque_destroy(deque);
+    
+    // Invalid arguments
+    assert(stack_deque_init(NULL, 4, sizeof(int)) == STACK_NULL_PTR);
+    assert(stack_deque_init(&deque, 0, sizeof(int)) == STACK_INVALID_ARGS);
+    assert(stack_deque_init(&deque, 4, 0) == STACK_INVALID_ARGS);
+    assert(stack_deque_destroy(NULL) == STACK_NULL_PTR);
+    
+    printf("stack_deque_init tests passed!\n\n");
+}
+
+void test_stack_deque_push_pop_steal() {
+    printf("Testing stack_deque push/pop/steal...\n");
+    
+    StackDeque* deque = NULL;
+    TestItem item = {0, ""};
+    TestItem out = {0, ""};
+    size_t size = 0;
+    
+    assert(stack_deque_init(&deque, 2, sizeof(TestItem)) == STACK_OK);
+    assert(stack_deque_pop(deque, &out) == STACK_EMPTY);
+    assert(stack_deque_steal(deque, &out) == STACK_EMPTY);
+    assert(stack_deque_push(deque, NULL) == STACK_NULL_DATA);
+    assert(stack_deque_pop(deque, NULL) == STACK_NULL_OUT);
+    assert(stack_deque_steal(deque, NULL) == STACK_NULL_OUT);
+    
+    // Push past the initial capacity
+    for (int i = 0; i < 20; i++) {
+        item.id = i;
+        snprintf(item.name, sizeof(item.name), "task%d", i);
+        assert(stack_deque_push(deque, &item) == STACK_OK);
+    }
+    assert(stack_deque_size(deque, &size) == STACK_OK);
+    assert(size == 20);
+    assert(atomic_load(&deque->buffer)->capacity == 32);
+    
+    // The owner pops the newest elements
+    assert(stack_deque_pop(deque, &out) == STACK_OK);
+    assert(out.id == 19);
+    assert(strcmp(out.name, "task19") == 0);
+    
+    // Thieves take the oldest elements
+    assert(stack_deque_steal(deque, &out) == STACK_OK);
+    assert(out.id == 0);
+    assert(stack_deque_steal(deque, &out) == STACK_OK);
+    assert(out.id == 1);
+    
+    for (int i = 18; i >= 2; i--) {
+        assert(stack_deque_pop(deque, &out) == STACK_OK);
+        assert(out.id == i);
+    }
+    assert(stack_deque_pop(deque, &out) == STACK_EMPTY);
+    assert(stack_deque_steal(deque, &out) == STACK_EMPTY);
+    assert(stack_deque_size(deque, &size) == STACK_OK);
+    assert(size == 0);
+    // A failed pop or steal leaves the output untouched
+    assert(out.id == 2);
+    
+    // Wrap around the circular buffer
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 24; i++) {
+            item.id = round * 100 + i;
+            assert(stack_deque_push(deque, &item) == STACK_OK);
+        }
+        for (int i = 0; i < 12; i++) {
+            assert(stack_deque_steal(deque, &out) == STACK_OK);
+            assert(out.id == round * 100 + i);
+        }
+        for (int i = 23; i >= 12; i--) {
+            assert(stack_deque_pop(deque, &out) == STACK_OK);
+            assert(out.id == round * 100 + i);
+        }
+    }
+    assert(atomic_load(&deque->buffer)->capacity == 32);
+    
+    stack_deque_destroy(deque);
+    printf("stack_deque push/pop/steal tests passed!\n\n");
+}
+
+typedef struct {
+    StackDeque* deque;
+    unsigned char* seen;
+    atomic_int* done;
+} ThiefArgs;
+
+static void* thief_worker(void* arg) {
+    ThiefArgs* args = arg;
+    int value = 0;
+    
+    // The owner drains the deque before setting done
+    while (!atomic_load(args->done)) {
+        if (stack_deque_steal(args->deque, &value) == STACK_OK) {
+            __atomic_fetch_add(&args->seen[value], 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+void test_stack_deque_large_blocks() {
+    printf("Testing stack_deque with large blocks...\n");
+    
+    StackDeque* deque = NULL;
+    unsigned char block[1000];
+    unsigned char out[1000];
+    
+    // Blocks larger than the on-stack staging buffer of a thief
+    assert(stack_deque_init(&deque, 4, sizeof(block)) == STACK_OK);
+    for (int i = 0; i < 3; i++) {
+        memset(block, 'a' + i, sizeof(block));
+        assert(stack_deque_push(deque, block) == STACK_OK);
+    }
+    assert(stack_deque_steal(deque, out) == STACK_OK);
+    assert(out[0] == 'a' && out[sizeof(out) - 1] == 'a');
+    assert(stack_deque_pop(deque, out) == STACK_OK);
+    assert(out[0] == 'c' && out[sizeof(out) - 1] == 'c');
+    assert(stack_deque_steal(deque, out) == STACK_OK);
+    assert(out[0] == 'b' && out[sizeof(out) - 1] == 'b');
+    assert(stack_deque_steal(deque, out) == STACK_EMPTY);
+    assert(out[0] == 'b');
+    stack_deque_destroy(deque);
+    
+    printf("stack_deque large block tests passed!\n\n");
+}
+
+void test_stack_deque_stress() {
+    printf("Testing stack_deque with concurrent thieves...\n");
+    
+    StackDeque* deque = NULL;
+    pthread_t thieves[STRESS_THIEVES];
+    ThiefArgs args;
+    atomic_int done;
+    unsigned char* seen = calloc(STRESS_VALUES, 1);
+    int value = 0;
+    assert(seen != NULL);
+    
+    atomic_init(&done, 0);
+    assert(stack_deque_init(&deque, 4, sizeof(int)) == STACK_OK);
+    args.deque = deque;
+    args.seen = seen;
+    args.done = &done;
+    
+    for (int t = 0; t < STRESS_THIEVES; t++) {
+        assert(pthread_create(&thieves[t], NULL, thief_worker, &args) == 0);
+    }
+    
+    // The owner pushes everything and pops part of it back
+    for (int i = 0; i < STRESS_VALUES; i++) {
+        assert(stack_deque_push(deque, &i) == STACK_OK);
+        if (i % 3 == 0 && stack_deque_pop(deque, &value) == STACK_OK) {
+            __atomic_fetch_add(&seen[value], 1, __ATOMIC_RELAXED);
+        }
+    }
+    while (stack_deque_pop(deque, &value) == STACK_OK) {
+        __atomic_fetch_add(&seen[value], 1, __ATOMIC_RELAXED);
+    }
+    
+    atomic_store(&done, 1);
+    for (int t = 0; t < STRESS_THIEVES; t++) {
+        pthread_join(thieves[t], NULL);
+    }
+    
+    // Every element is taken exactly once
+    for (int i = 0; i < STRESS_VALUES; i++) {
+        assert(seen[i] == 1);
+    }
+    
+    stack_deque_destroy(deque);
+    free(seen);
+    printf("stack_deque concurrent thieves tests passed!\n\n");
+}
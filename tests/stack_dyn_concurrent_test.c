@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stack_dyn_concurrent.h>
+
+#define STRESS_THREADS 8
+#define STRESS_VALUES  20000
+
+static void* copy_int(const void* data) {
+    int* copy = malloc(sizeof(int));
+    if (copy) *copy = *(const int*)data;
+    return copy;
+}
+
+void test_stack_dyn_concurrent_init() {
+    printf("Testing stack_dyn_concurrent_init...\n");
+    
+    StackDynConcurrent* stack = NULL;
+    
+    assert(stack_dyn_concurrent_init(&stack, copy_int, free) == STACK_OK);
+    assert(stack != NULL);
+    assert(atomic_load(&stack->top) == NULL);
+    stack_dyn_concurrent_destroy(stack);
+    
+    assert(stack_dyn_concurrent_init(&stack, NULL, NULL) == STACK_OK);
+    stack_dyn_concurrent_destroy(stack);
+    
+    // Invalid arguments
+    assert(stack_dyn_concurrent_init(NULL, NULL, NULL) == STACK_NULL_PTR);
+    assert(stack_dyn_concurrent_init(&stack, copy_int, NULL) == STACK_INVALID_ARGS);
+    assert(stack_dyn_concurrent_destroy(NULL) == STACK_NULL_PTR);
+    
+    printf("stack_dyn_concurrent_init tests passed!\n\n");
+}
+
+void test_stack_dyn_concurrent_push_pop() {
+    printf("Testing stack_dyn_concurrent push/pop...\n");
+    
+    StackDynConcurrent* stack = NULL;
+    assert(stack_dyn_concurrent_init(&stack, copy_int, free) == STACK_OK);
+    
+    void* data = NULL;
+    bool is_empty = false;
+    size_t size = 0;
+    
+    assert(stack_dyn_concurrent_is_empty(stack, &is_empty) == STACK_OK);
+    assert(is_empty == true);
+    assert(stack_dyn_concurrent_pop(stack, &data) == STACK_EMPTY);
+    assert(stack_dyn_concurrent_pop(stack, NULL) == STACK_NULL_OUT);
+    assert(stack_dyn_concurrent_push(stack, NULL) == STACK_NULL_DATA);
+    
+    // LIFO order with deep copies
+    for (int i = 0; i < 300; i++) {
+        assert(stack_dyn_concurrent_push(stack, &i) == STACK_OK);
+    }
+    assert(stack_dyn_concurrent_size(stack, &size) == STACK_OK);
+    assert(size == 300);
+    
+    for (int i = 299; i >= 100; i--) {
+        assert(stack_dyn_concurrent_pop(stack, &data) == STACK_OK);
+        assert(*(int*)data == i);
+        free(data);
+    }
+    
+    // Clearing frees the remaining copies
+    assert(stack_dyn_concurrent_clear(stack) == STACK_OK);
+    assert(stack_dyn_concurrent_size(stack, &size) == STACK_OK);
+    assert(size == 0);
+    assert(stack_dyn_concurrent_is_empty(stack, &is_empty) == STACK_OK);
+    assert(is_empty == true);
+    
+    stack_dyn_concurrent_destroy(stack);
+    printf("stack_dyn_concurrent push/pop tests passed!\n\n");
+}
+
+typedef struct {
+    StackDynConcurrent* stack;
+    int first;
+    unsigned char* seen;
+} StressArgs;
+
+static void* stress_worker(void* arg) {
+    StressArgs* args = arg;
+    void* data = NULL;
+    
+    // Push own values and pop whatever is on top, interleaved
+    for (int i = 0; i < STRESS_VALUES; i++) {
+        assert(stack_dyn_concurrent_push(args->stack, (void*)(size_t)(args->first + i + 1)) == STACK_OK);
+        if (i % 2 && stack_dyn_concurrent_pop(args->stack, &data) == STACK_OK) {
+            __atomic_fetch_add(&args->seen[(size_t)data - 1], 1, __ATOMIC_RELAXED);
+        }
+    }
+    
+    while (stack_dyn_concurrent_pop(args->stack, &data) == STACK_OK) {
+        __atomic_fetch_add(&args->seen[(size_t)data - 1], 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+static void run_stress(StackDynConcurrent* stack) {
+    pthread_t threads[STRESS_THREADS];
+    StressArgs args[STRESS_THREADS];
+    size_t total = (size_t)STRESS_THREADS * STRESS_VALUES;
+    unsigned char* seen = calloc(total, 1);
+    assert(seen != NULL);
+    
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        args[t].stack = stack;
+        args[t].first = t * STRESS_VALUES;
+        args[t].seen = seen;
+        assert(pthread_create(&threads[t], NULL, stress_worker, &args[t]) == 0);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    
+    // Every value is popped exactly once
+    for (size_t i = 0; i < total; i++) {
+        assert(seen[i] == 1);
+    }
+    
+    size_t size = 1;
+    assert(stack_dyn_concurrent_size(stack, &size) == STACK_OK);
+    assert(size == 0);
+    
+    free(seen);
+}
+
+void test_stack_dyn_concurrent_stress() {
+    printf("Testing stack_dyn_concurrent under contention...\n");
+    
+    StackDynConcurrent* stack = NULL;
+    assert(stack_dyn_concurrent_init(&stack, NULL, NULL) == STACK_OK);
+    run_stress(stack);
+    stack_dyn_concurrent_destroy(stack);
+    
+    printf("stack_dyn_concurrent contention tests passed!\n\n");
+}
+
+void test_stack_dyn_concurrent_elimination() {
+    printf("Testing stack_dyn_concurrent with elimination...\n");
+    
+    StackDynConcurrent* stack = NULL;
+    void* data = NULL;
+    
+    assert(stack_dyn_concurrent_init_elimination(NULL, NULL, NULL, 4) == STACK_NULL_PTR);
+    assert(stack_dyn_concurrent_init_elimination(&stack, NULL, NULL, 0) == STACK_INVALID_ARGS);
+    assert(stack_dyn_concurrent_init_elimination(&stack, copy_int, NULL, 4) == STACK_INVALID_ARGS);
+    
+    // Deep copies pass through the elimination array unchanged
+    assert(stack_dyn_concurrent_init_elimination(&stack, copy_int, free, 4) == STACK_OK);
+    assert(stack->elimination != NULL);
+    assert(atomic_load(&stack->elimination_width) == 1);
+    for (int i = 0; i < 10; i++) {
+        assert(stack_dyn_concurrent_push(stack, &i) == STACK_OK);
+    }
+    for (int i = 9; i >= 0; i--) {
+        assert(stack_dyn_concurrent_pop(stack, &data) == STACK_OK);
+        assert(*(int*)data == i);
+        free(data);
+    }
+    assert(stack_dyn_concurrent_pop(stack, &data) == STACK_EMPTY);
+    stack_dyn_concurrent_destroy(stack);
+    
+    assert(stack_dyn_concurrent_init_elimination(&stack, NULL, NULL, 8) == STACK_OK);
+    run_stress(stack);
+    assert(atomic_load(&stack->elimination_width) >= 1);
+    assert(atomic_load(&stack->elimination_width) <= 8);
+    stack_dyn_concurrent_destroy(stack);
+    
+    printf("stack_dyn_concurrent elimination tests passed!\n\n");
+}
@@ -1,8 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <assert.h>
+#include <poll.h>
 #include <stack_dyn.h>
+#include <stack_fast.h>
 
 // Helper functions for testing
 void* copy_string(const void* data) {
@@ -122,3 +126,358 @@ void test_stack_dyn_clear_is_empty() {
     stack_dyn_destroy(stack);
     printf("stack_dyn clear/is_empty tests passed!\n\n");
 }
+
+void test_stack_dyn_slab_reuse() {
+    printf("Testing stack_dyn slab reuse...\n");
+    
+    StackDyn* stack = NULL;
+    assert(stack_dyn_init(&stack, NULL, NULL) == STACK_OK);
+    assert(stack->slabs == NULL);
+    
+    size_t count = STACK_DYN_SLAB_NODES * 2 + 1;
+    void* data = NULL;
+    
+    // Push enough elements to span three slabs
+    for (size_t i = 0; i < count; i++) {
+        assert(stack_dyn_push(stack, (void*)(i + 1)) == STACK_OK);
+    }
+    assert(stack->size == count);
+    
+    StSlab* slabs = stack->slabs;
+    assert(slabs != NULL);
+    
+    // Pop everything, nodes go to the free list
+    for (size_t i = count; i > 0; i--) {
+        assert(stack_dyn_pop(stack, &data) == STACK_OK);
+        assert((size_t)data == i);
+    }
+    assert(stack->free_nodes != NULL);
+    
+    // Pushing again reuses popped nodes without new slabs
+    for (size_t i = 0; i < count; i++) {
+        assert(stack_dyn_push(stack, (void*)(i + 1)) == STACK_OK);
+    }
+    assert(stack->slabs == slabs);
+    assert(stack->free_nodes == NULL);
+    
+    // Clearing releases all slabs
+    assert(stack_dyn_clear(stack) == STACK_OK);
+    assert(stack->slabs == NULL);
+    assert(stack->free_nodes == NULL);
+    
+    // The stack is still usable after clearing
+    assert(stack_dyn_push(stack, (void*)1) == STACK_OK);
+    assert(stack_dyn_pop(stack, &data) == STACK_OK);
+    assert((size_t)data == 1);
+    
+    stack_dyn_destroy(stack);
+    printf("stack_dyn slab reuse tests passed!\n\n");
+}
+
+void test_stack_dyn_chunked() {
+    printf("Testing stack_dyn chunked storage...\n");
+    
+    StackDyn* stack = NULL;
+    char buffer[16];
+    void* data = NULL;
+    size_t count = STACK_DYN_CHUNK_ITEMS * 2 + 5;
+    
+    assert(stack_dyn_init_chunked(NULL, NULL, NULL) == STACK_NULL_PTR);
+    assert(stack_dyn_init_chunked(&stack, copy_string, NULL) == STACK_INVALID_ARGS);
+    assert(stack_dyn_init_chunked(&stack, copy_string, destroy_string) == STACK_OK);
+    assert(stack->chunked == true);
+    
+    // Push elements across several chunks
+    for (size_t i = 0; i < count; i++) {
+        snprintf(buffer, sizeof(buffer), "%zu", i);
+        assert(stack_dyn_push(stack, buffer) == STACK_OK);
+    }
+    assert(stack->size == count);
+    assert(stack->top == NULL);
+    
+    // Peek and pop back over a chunk boundary
+    assert(stack_dyn_peek(stack, &data) == STACK_OK);
+    snprintf(buffer, sizeof(buffer), "%zu", count - 1);
+    assert(strcmp((char*)data, buffer) == 0);
+    
+    for (size_t i = count; i > STACK_DYN_CHUNK_ITEMS - 1; i--) {
+        assert(stack_dyn_pop(stack, &data) == STACK_OK);
+        snprintf(buffer, sizeof(buffer), "%zu", i - 1);
+        assert(strcmp((char*)data, buffer) == 0);
+        destroy_string(data);
+    }
+    assert(stack->size == STACK_DYN_CHUNK_ITEMS - 1);
+    assert(stack->spare_chunk != NULL);
+    
+    // Push NULL with copy function
+    assert(stack_dyn_push(stack, NULL) == STACK_NULL_DATA);
+    
+    // Clearing frees the remaining copies chunk by chunk
+    assert(stack_dyn_clear(stack) == STACK_OK);
+    assert(stack->size == 0);
+    assert(stack->chunk == NULL);
+    assert(stack_dyn_pop(stack, &data) == STACK_EMPTY);
+    
+    stack_dyn_destroy(stack);
+    
+    // Shallow copying
+    assert(stack_dyn_init_chunked(&stack, NULL, NULL) == STACK_OK);
+    int x = 42;
+    assert(stack_dyn_push(stack, &x) == STACK_OK);
+    assert(stack_dyn_push(stack, NULL) == STACK_OK);
+    assert(stack_dyn_pop(stack, &data) == STACK_OK);
+    assert(data == NULL);
+    assert(stack_dyn_pop(stack, &data) == STACK_OK);
+    assert(*(int*)data == x);
+    assert(stack->chunk == NULL);
+    
+    stack_dyn_destroy(stack);
+    printf("stack_dyn chunked storage tests passed!\n\n");
+}
+
+void test_stack_dyn_push_pop_n() {
+    printf("Testing stack_dyn push_n/pop_n...\n");
+    
+    StackDyn* stack = NULL;
+    StackError (*inits[])(StackDyn**, stack_copy_data, stack_destroy_data) = {
+        stack_dyn_init, stack_dyn_init_chunked
+    };
+    size_t count = STACK_DYN_CHUNK_ITEMS * 3;
+    void** values = malloc(count * sizeof(void*));
+    void** out = malloc(count * sizeof(void*));
+    size_t done = 0;
+    
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (void*)(i + 1);
+    }
+    
+    for (size_t k = 0; k < 2; k++) {
+        // Shallow copying
+        assert(inits[k](&stack, NULL, NULL) == STACK_OK);
+        assert(stack_dyn_push_n(NULL, values, count, &done) == STACK_NULL_PTR);
+        assert(stack_dyn_push_n(stack, NULL, count, &done) == STACK_NULL_DATA);
+        assert(stack_dyn_push_n(stack, values, 5, &done) == STACK_OK);
+        assert(done == 5);
+        assert(stack_dyn_push_n(stack, values + 5, count - 5, NULL) == STACK_OK);
+        assert(stack->size == count);
+        
+        void* data = NULL;
+        assert(stack_dyn_pop(stack, &data) == STACK_OK);
+        assert(data == values[count - 1]);
+        
+        // Pop keeps the stack order
+        assert(stack_dyn_pop_n(stack, out, STACK_DYN_CHUNK_ITEMS + 3, &done) == STACK_OK);
+        assert(done == STACK_DYN_CHUNK_ITEMS + 3);
+        for (size_t i = 0; i < done; i++) {
+            assert(out[i] == values[count - 1 - done + i]);
+        }
+        
+        // Pop more than available
+        size_t left = stack->size;
+        assert(stack_dyn_pop_n(stack, NULL, 1, &done) == STACK_NULL_OUT);
+        assert(stack_dyn_pop_n(stack, out, count, &done) == STACK_EMPTY);
+        assert(done == left);
+        for (size_t i = 0; i < left; i++) {
+            assert(out[i] == values[i]);
+        }
+        assert(stack->size == 0);
+        assert(stack_dyn_pop(stack, &data) == STACK_EMPTY);
+        
+        stack_dyn_destroy(stack);
+        
+        // Deep copying stops at the first NULL element
+        char* strings[] = {"one", "two", NULL, "four"};
+        assert(inits[k](&stack, copy_string, destroy_string) == STACK_OK);
+        assert(stack_dyn_push_n(stack, (void* const*)strings, 4, &done) == STACK_NULL_DATA);
+        assert(done == 2);
+        assert(stack->size == 2);
+        assert(stack_dyn_pop_n(stack, out, 2, &done) == STACK_OK);
+        assert(strcmp(out[0], "one") == 0 && strcmp(out[1], "two") == 0);
+        assert(out[0] != strings[0]);
+        destroy_string(out[0]);
+        destroy_string(out[1]);
+        stack_dyn_destroy(stack);
+    }
+    
+    free(values);
+    free(out);
+    printf("stack_dyn push_n/pop_n tests passed!\n\n");
+}
+
+void test_stack_dyn_unchecked() {
+    printf("Testing stack_dyn unchecked operations...\n");
+    
+    StackError (*inits[])(StackDyn**, stack_copy_data, stack_destroy_data) = {
+        stack_dyn_init, stack_dyn_init_chunked
+    };
+    size_t count = STACK_DYN_SLAB_NODES * 2 + 3;
+    
+    for (size_t k = 0; k < 2; k++) {
+        StackDyn* stack = NULL;
+        void* data = NULL;
+        
+        assert(inits[k](&stack, NULL, NULL) == STACK_OK);
+        assert(stack_dyn_pop_unchecked(stack, &data) == STACK_EMPTY);
+        assert(stack_dyn_peek_unchecked(stack, &data) == STACK_EMPTY);
+        
+        for (size_t i = 0; i < count; i++) {
+            assert(stack_dyn_push_unchecked(stack, (void*)(i + 1)) == STACK_OK);
+        }
+        assert(stack_dyn_size_unchecked(stack) == count);
+        assert(stack_dyn_peek_unchecked(stack, &data) == STACK_OK);
+        assert((size_t)data == count);
+        
+        for (size_t i = count; i > 0; i--) {
+            if (i % 5)
+                assert(stack_dyn_pop_unchecked(stack, &data) == STACK_OK);
+            else
+                assert(stack_dyn_pop(stack, &data) == STACK_OK);
+            assert((size_t)data == i);
+        }
+        assert(stack_dyn_size_unchecked(stack) == 0);
+        assert(stack_dyn_pop_unchecked(stack, &data) == STACK_EMPTY);
+        
+        stack_dyn_destroy(stack);
+    }
+    
+    // Deep copying goes through the checked path
+    StackDyn* stack = NULL;
+    void* data = NULL;
+    assert(stack_dyn_init(&stack, copy_string, destroy_string) == STACK_OK);
+    assert(stack_dyn_push_unchecked(stack, "Hello") == STACK_OK);
+    assert(stack_dyn_pop_unchecked(stack, &data) == STACK_OK);
+    assert(strcmp((char*)data, "Hello") == 0);
+    destroy_string(data);
+    stack_dyn_destroy(stack);
+    
+    printf("stack_dyn unchecked operations tests passed!\n\n");
+}
+
+void test_stack_dyn_events() {
+    printf("Testing stack_dyn readiness descriptor...\n");
+    
+#ifdef __linux__
+    for (int chunked = 0; chunked < 2; chunked++) {
+        StackDyn* stack = NULL;
+        struct pollfd pfd = {-1, POLLIN, 0};
+        void* items[8] = {0};
+        void* data = NULL;
+        int fd = -1;
+        
+        if (chunked)
+            assert(stack_dyn_init_chunked(&stack, NULL, NULL) == STACK_OK);
+        else
+            assert(stack_dyn_init(&stack, NULL, NULL) == STACK_OK);
+        assert(stack_dyn_event_open(stack, 0, &fd) == STACK_OK);
+        pfd.fd = fd;
+        
+        // Empty to non-empty, even on the unchecked path
+        assert(poll(&pfd, 1, 0) == 0);
+        assert(stack_dyn_push_unchecked(stack, items) == STACK_OK);
+        assert(stack_dyn_push(stack, items) == STACK_OK);
+        assert(poll(&pfd, 1, 0) == 1);
+        assert(stack_dyn_event_ack(stack) == STACK_OK);
+        assert(poll(&pfd, 1, 0) == 0);
+        
+        // Without a watermark only the empty to non-empty edge counts
+        assert(stack_dyn_pop_n(stack, items, 2, NULL) == STACK_OK);
+        assert(poll(&pfd, 1, 0) == 0);
+        assert(stack_dyn_push_n(stack, items, 8, NULL) == STACK_OK);
+        assert(poll(&pfd, 1, 0) == 1);
+        
+        // Re-opening sets a watermark and re-arms
+        assert(stack_dyn_event_open(stack, 4, &fd) == STACK_OK);
+        assert(fd == pfd.fd);
+        assert(stack_dyn_event_ack(stack) == STACK_OK);
+        for (int i = 0; i < 4; i++) {
+            assert(stack_dyn_pop_unchecked(stack, &data) == STACK_OK);
+            assert(poll(&pfd, 1, 0) == 0);
+        }
+        assert(stack_dyn_pop(stack, &data) == STACK_OK);
+        assert(poll(&pfd, 1, 0) == 1);
+        
+        stack_dyn_destroy(stack);
+    }
+#endif
+    
+    printf("stack_dyn readiness descriptor tests passed!\n\n");
+}
+
+typedef struct {
+    long double weight;
+    int id;
+    char tag[13];
+} SizedRecord;
+
+void test_stack_dyn_sized() {
+    printf("Testing stack_dyn sized mode...\n");
+    
+    StackDyn* stack = NULL;
+    SizedRecord record = {0.5L, 0, "record"};
+    SizedRecord out;
+    void* data = NULL;
+    const void* batch[3] = {&record, &record, &record};
+    
+    assert(stack_dyn_init_sized(NULL, sizeof(SizedRecord)) == STACK_NULL_PTR);
+    assert(stack_dyn_init_sized(&stack, 0) == STACK_INVALID_ARGS);
+    assert(stack_dyn_init_sized(&stack, (size_t)-1) == STACK_INVALID_ARGS);
+    assert(stack_dyn_init_sized(&stack, sizeof(SizedRecord)) == STACK_OK);
+    
+    assert(stack_dyn_pop_into(NULL, &out) == STACK_NULL_PTR);
+    assert(stack_dyn_pop_into(stack, NULL) == STACK_NULL_OUT);
+    assert(stack_dyn_pop_into(stack, &out) == STACK_EMPTY);
+    assert(stack_dyn_push(stack, NULL) == STACK_NULL_DATA);
+    
+    // The records are copied, later changes to the source do not matter
+    for (int i = 0; i < 1000; i++) {
+        record.id = i;
+        assert(stack_dyn_push(stack, &record) == STACK_OK);
+    }
+    record.id = -1;
+    
+    // Peek points into the node, the payload is aligned for any type
+    assert(stack_dyn_peek(stack, &data) == STACK_OK);
+    assert(((SizedRecord*)data)->id == 999);
+    assert((uintptr_t)data % _Alignof(max_align_t) == 0);
+    
+    // Handing out the payload pointer is refused
+    assert(stack_dyn_pop(stack, &data) == STACK_INVALID_ARGS);
+    assert(stack_dyn_pop_n(stack, &data, 1, NULL) == STACK_INVALID_ARGS);
+    assert(stack_dyn_pop_unchecked(stack, &data) == STACK_INVALID_ARGS);
+    
+    for (int i = 999; i >= 500; i--) {
+        assert(stack_dyn_pop_into(stack, &out) == STACK_OK);
+        assert(out.id == i);
+        assert(out.weight == 0.5L);
+        assert(strcmp(out.tag, "record") == 0);
+    }
+    
+    // Popped nodes are reused before new slabs are carved
+    StSlab* slabs = stack->slabs;
+    size_t slab_used = stack->slab_used;
+    record.id = 7;
+    assert(stack_dyn_push_unchecked(stack, &record) == STACK_OK);
+    assert(stack_dyn_push_n(stack, (void* const*)batch, 3, NULL) == STACK_OK);
+    assert(stack->slabs == slabs && stack->slab_used == slab_used);
+    assert(stack_dyn_size_unchecked(stack) == 504);
+    for (int i = 0; i < 4; i++) {
+        assert(stack_dyn_pop_into(stack, &out) == STACK_OK);
+        assert(out.id == 7);
+    }
+    assert(stack_dyn_pop_into(stack, &out) == STACK_OK);
+    assert(out.id == 499);
+    
+    // A plain stack has no payload to pop into
+    StackDyn* plain = NULL;
+    assert(stack_dyn_init(&plain, NULL, NULL) == STACK_OK);
+    assert(stack_dyn_push(plain, &record) == STACK_OK);
+    assert(stack_dyn_pop_into(plain, &out) == STACK_INVALID_ARGS);
+    stack_dyn_destroy(plain);
+    
+    assert(stack_dyn_clear(stack) == STACK_OK);
+    assert(stack_dyn_pop_into(stack, &out) == STACK_EMPTY);
+    assert(stack_dyn_push(stack, &record) == STACK_OK);
+    stack_dyn_destroy(stack);
+    
+    printf("stack_dyn sized mode tests passed!\n\n");
+}
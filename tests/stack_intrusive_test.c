@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <stack_intrusive.h>
+
+// Object living outside the stack, hooked onto it through link
+typedef struct {
+    int id;
+    StackLink link;
+    double payload;
+} PooledItem;
+
+void test_stack_intrusive_push_pop() {
+    printf("Testing stack_intrusive push/pop...\n");
+
+    StackIntrusive stack;
+    PooledItem items[5];
+    StackLink* link = NULL;
+    bool empty = false;
+    size_t size = 0;
+
+    assert(stack_intrusive_init(NULL) == STACK_NULL_PTR);
+    assert(stack_intrusive_init(&stack) == STACK_OK);
+    assert(stack_intrusive_push(NULL, &items[0].link) == STACK_NULL_PTR);
+    assert(stack_intrusive_push(&stack, NULL) == STACK_NULL_DATA);
+    assert(stack_intrusive_pop(NULL, &link) == STACK_NULL_PTR);
+    assert(stack_intrusive_pop(&stack, NULL) == STACK_NULL_OUT);
+    assert(stack_intrusive_pop(&stack, &link) == STACK_EMPTY);
+    assert(stack_intrusive_peek(&stack, &link) == STACK_EMPTY);
+    assert(stack_intrusive_is_empty(&stack, &empty) == STACK_OK && empty);
+    assert(stack_intrusive_size(&stack, NULL) == STACK_NULL_OUT);
+
+    for (int i = 0; i < 5; i++) {
+        items[i].id = i;
+        assert(stack_intrusive_push(&stack, &items[i].link) == STACK_OK);
+    }
+    assert(stack_intrusive_size(&stack, &size) == STACK_OK && size == 5);
+    assert(stack_intrusive_is_empty(&stack, &empty) == STACK_OK && !empty);
+
+    assert(stack_intrusive_peek(&stack, &link) == STACK_OK);
+    assert(STACK_CONTAINER_OF(link, PooledItem, link)->id == 4);
+
+    for (int i = 4; i >= 0; i--) {
+        assert(stack_intrusive_pop(&stack, &link) == STACK_OK);
+        PooledItem* item = STACK_CONTAINER_OF(link, PooledItem, link);
+        assert(item == &items[i]);
+        assert(link->next == NULL);
+    }
+    assert(stack_intrusive_pop(&stack, &link) == STACK_EMPTY);
+    assert(stack.bottom == NULL);
+
+    // Popped objects can be pushed again, as on a free list
+    assert(stack_intrusive_push(&stack, &items[2].link) == STACK_OK);
+    assert(stack_intrusive_clear(&stack) == STACK_OK);
+    assert(stack_intrusive_size(&stack, &size) == STACK_OK && size == 0);
+    assert(stack_intrusive_clear(NULL) == STACK_NULL_PTR);
+
+    printf("stack_intrusive push/pop tests passed!\n\n");
+}
+
+void test_stack_intrusive_splice() {
+    printf("Testing stack_intrusive_splice...\n");
+
+    StackIntrusive stack;
+    StackIntrusive source;
+    PooledItem items[6];
+    StackLink* link = NULL;
+    size_t size = 0;
+
+    for (int i = 0; i < 6; i++)
+        items[i].id = i;
+
+    assert(stack_intrusive_init(&stack) == STACK_OK);
+    assert(stack_intrusive_init(&source) == STACK_OK);
+    assert(stack_intrusive_splice(NULL, &source) == STACK_NULL_PTR);
+    assert(stack_intrusive_splice(&stack, NULL) == STACK_NULL_PTR);
+    assert(stack_intrusive_splice(&stack, &stack) == STACK_INVALID_ARGS);
+
+    // Empty source leaves the stack as it is
+    assert(stack_intrusive_splice(&stack, &source) == STACK_OK);
+    assert(stack_intrusive_size(&stack, &size) == STACK_OK && size == 0);
+
+    // Splicing into an empty stack takes the bottom over
+    assert(stack_intrusive_push(&source, &items[0].link) == STACK_OK);
+    assert(stack_intrusive_push(&source, &items[1].link) == STACK_OK);
+    assert(stack_intrusive_splice(&stack, &source) == STACK_OK);
+    assert(stack.bottom == &items[0].link);
+    assert(source.top == NULL && source.bottom == NULL && source.size == 0);
+
+    for (int i = 2; i < 6; i++)
+        assert(stack_intrusive_push(&source, &items[i].link) == STACK_OK);
+    assert(stack_intrusive_splice(&stack, &source) == STACK_OK);
+    assert(stack_intrusive_size(&stack, &size) == STACK_OK && size == 6);
+    assert(stack_intrusive_size(&source, &size) == STACK_OK && size == 0);
+    assert(stack.bottom == &items[0].link);
+
+    // Source links keep their order above the old top
+    for (int i = 5; i >= 0; i--) {
+        assert(stack_intrusive_pop(&stack, &link) == STACK_OK);
+        assert(STACK_CONTAINER_OF(link, PooledItem, link)->id == i);
+    }
+    assert(stack_intrusive_pop(&stack, &link) == STACK_EMPTY);
+
+    printf("stack_intrusive_splice tests passed!\n\n");
+}
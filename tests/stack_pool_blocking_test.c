@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <pthread.h>
+#include <stack_pool_blocking.h>
+
+#define HANDOFF_PRODUCERS 3
+#define HANDOFF_CONSUMERS 3
+#define HANDOFF_VALUES    10000
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void test_stack_pool_blocking_init() {
+    printf("Testing stack_pool_blocking_init...\n");
+    
+    StackPoolBlocking* stack = NULL;
+    size_t size = 1;
+    
+    assert(stack_pool_blocking_init(&stack, 10, sizeof(int)) == STACK_OK);
+    assert(stack != NULL);
+    assert(stack->pool->capacity == 10);
+    assert(stack_pool_blocking_size(stack, &size) == STACK_OK);
+    assert(size == 0);
+    stack_pool_blocking_destroy(stack);
+    
+    // Invalid arguments
+    assert(stack_pool_blocking_init(NULL, 10, sizeof(int)) == STACK_NULL_PTR);
+    assert(stack_pool_blocking_init(&stack, 0, sizeof(int)) == STACK_INVALID_ARGS);
+    assert(stack_pool_blocking_init(&stack, 10, 0) == STACK_INVALID_ARGS);
+    assert(stack_pool_blocking_destroy(NULL) == STACK_NULL_PTR);
+    
+    printf("stack_pool_blocking_init tests passed!\n\n");
+}
+
+void test_stack_pool_blocking_timeout() {
+    printf("Testing stack_pool_blocking timeouts...\n");
+    
+    StackPoolBlocking* stack = NULL;
+    int value = 7;
+    int out = 0;
+    
+    assert(stack_pool_blocking_init(&stack, 2, sizeof(int)) == STACK_OK);
+    assert(stack_pool_blocking_push(stack, NULL) == STACK_NULL_DATA);
+    assert(stack_pool_blocking_pop_wait(stack, NULL, 0) == STACK_NULL_OUT);
+    
+    // Non-blocking calls report the state at once
+    assert(stack_pool_blocking_pop(stack, &out) == STACK_EMPTY);
+    
+    // A timed pop on an empty stack waits for the timeout
+    int64_t start = now_ns();
+    assert(stack_pool_blocking_pop_wait(stack, &out, 20000000) == STACK_TIMEOUT);
+    assert(now_ns() - start >= 20000000);
+#ifndef STACK_NO_LAST_ERROR
+    assert(stack_get_last_error() == STACK_TIMEOUT);
+#endif
+    
+    assert(stack_pool_blocking_push(stack, &value) == STACK_OK);
+    assert(stack_pool_blocking_push_wait(stack, &value, STACK_WAIT_FOREVER) == STACK_OK);
+    assert(stack_pool_blocking_push(stack, &value) == STACK_FULL);
+    
+    start = now_ns();
+    assert(stack_pool_blocking_push_wait(stack, &value, 20000000) == STACK_TIMEOUT);
+    assert(now_ns() - start >= 20000000);
+    
+    assert(stack_pool_blocking_pop_wait(stack, &out, 20000000) == STACK_OK);
+    assert(out == 7);
+    
+    stack_pool_blocking_destroy(stack);
+    printf("stack_pool_blocking timeout tests passed!\n\n");
+}
+
+typedef struct {
+    StackPoolBlocking* stack;
+    int first;
+    unsigned char* seen;
+} HandoffArgs;
+
+static void* producer_worker(void* arg) {
+    HandoffArgs* args = arg;
+    
+    for (int i = 0; i < HANDOFF_VALUES; i++) {
+        int value = args->first + i;
+        assert(stack_pool_blocking_push_wait(args->stack, &value, STACK_WAIT_FOREVER) == STACK_OK);
+    }
+    return NULL;
+}
+
+static void* consumer_worker(void* arg) {
+    HandoffArgs* args = arg;
+    int value = 0;
+    
+    for (int i = 0; i < HANDOFF_VALUES; i++) {
+        assert(stack_pool_blocking_pop_wait(args->stack, &value, STACK_WAIT_FOREVER) == STACK_OK);
+        __atomic_fetch_add(&args->seen[value], 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+void test_stack_pool_blocking_handoff() {
+    printf("Testing stack_pool_blocking producer/consumer hand-off...\n");
+    
+    StackPoolBlocking* stack = NULL;
+    pthread_t producers[HANDOFF_PRODUCERS];
+    pthread_t consumers[HANDOFF_CONSUMERS];
+    HandoffArgs args[HANDOFF_PRODUCERS];
+    size_t total = (size_t)HANDOFF_PRODUCERS * HANDOFF_VALUES;
+    unsigned char* seen = calloc(total, 1);
+    size_t size = 1;
+    assert(seen != NULL);
+    
+    // A small stack keeps both sides waiting
+    assert(stack_pool_blocking_init(&stack, 4, sizeof(int)) == STACK_OK);
+    
+    for (int t = 0; t < HANDOFF_CONSUMERS; t++) {
+        args[t].stack = stack;
+        args[t].first = t * HANDOFF_VALUES;
+        args[t].seen = seen;
+        assert(pthread_create(&consumers[t], NULL, consumer_worker, &args[t]) == 0);
+    }
+    for (int t = 0; t < HANDOFF_PRODUCERS; t++) {
+        assert(pthread_create(&producers[t], NULL, producer_worker, &args[t]) == 0);
+    }
+    for (int t = 0; t < HANDOFF_PRODUCERS; t++) {
+        pthread_join(producers[t], NULL);
+    }
+    for (int t = 0; t < HANDOFF_CONSUMERS; t++) {
+        pthread_join(consumers[t], NULL);
+    }
+    
+    // Every value is handed over exactly once
+    for (size_t i = 0; i < total; i++) {
+        assert(seen[i] == 1);
+    }
+    assert(stack_pool_blocking_size(stack, &size) == STACK_OK);
+    assert(size == 0);
+    
+    stack_pool_blocking_destroy(stack);
+    free(seen);
+    printf("stack_pool_blocking hand-off tests passed!\n\n");
+}
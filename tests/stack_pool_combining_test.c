@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <poll.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <stack_pool_combining.h>
+
+#define STRESS_THREADS 8
+#define STRESS_VALUES  20000
+
+typedef struct {
+    int id;
+    char name[16];
+} TestStruct;
+
+void test_stack_pool_combining_init() {
+    printf("Testing stack_pool_combining_init...\n");
+    
+    StackPoolCombining* stack = NULL;
+    size_t size = 1;
+    
+    assert(stack_pool_combining_init(&stack, 10, sizeof(int)) == STACK_OK);
+    assert(stack != NULL);
+    assert(stack->pool->capacity == 10);
+    assert(stack->pool->block_size == sizeof(int));
+    assert(stack_pool_combining_size(stack, &size) == STACK_OK);
+    assert(size == 0);
+    stack_pool_combining_destroy(stack);
+    
+    // Invalid arguments
+    assert(stack_pool_combining_init(NULL, 10, sizeof(int)) == STACK_NULL_PTR);
+    assert(stack_pool_combining_init(&stack, 0, sizeof(int)) == STACK_INVALID_ARGS);
+    assert(stack_pool_combining_init(&stack, 10, 0) == STACK_INVALID_ARGS);
+    assert(stack_pool_combining_destroy(NULL) == STACK_NULL_PTR);
+    
+    printf("stack_pool_combining_init tests passed!\n\n");
+}
+
+void test_stack_pool_combining_push_pop() {
+    printf("Testing stack_pool_combining push/pop...\n");
+    
+    StackPoolCombining* stack = NULL;
+    TestStruct item = {0, ""};
+    TestStruct out = {0, ""};
+    size_t size = 0;
+    
+    assert(stack_pool_combining_init(&stack, 3, sizeof(TestStruct)) == STACK_OK);
+    assert(stack_pool_combining_pop(stack, &out) == STACK_EMPTY);
+    assert(stack_pool_combining_push(stack, NULL) == STACK_NULL_DATA);
+    assert(stack_pool_combining_pop(stack, NULL) == STACK_NULL_OUT);
+    assert(stack_pool_combining_size(stack, NULL) == STACK_NULL_OUT);
+    
+    for (int i = 0; i < 3; i++) {
+        item.id = i;
+        snprintf(item.name, sizeof(item.name), "item%d", i);
+        assert(stack_pool_combining_push(stack, &item) == STACK_OK);
+    }
+    assert(stack_pool_combining_push(stack, &item) == STACK_FULL);
+    assert(stack_pool_combining_size(stack, &size) == STACK_OK);
+    assert(size == 3);
+    
+    // LIFO order
+    for (int i = 2; i >= 0; i--) {
+        assert(stack_pool_combining_pop(stack, &out) == STACK_OK);
+        snprintf(item.name, sizeof(item.name), "item%d", i);
+        assert(out.id == i);
+        assert(strcmp(out.name, item.name) == 0);
+    }
+    assert(stack_pool_combining_pop(stack, &out) == STACK_EMPTY);
+    assert(stack_pool_combining_size(stack, &size) == STACK_OK);
+    assert(size == 0);
+    
+    stack_pool_combining_destroy(stack);
+    printf("stack_pool_combining push/pop tests passed!\n\n");
+}
+
+typedef struct {
+    StackPoolCombining* stack;
+    int first;
+    unsigned char* seen;
+} StressArgs;
+
+static void* stress_worker(void* arg) {
+    StressArgs* args = arg;
+    int value = 0;
+    
+    // Push own values and pop whatever is on top, interleaved
+    for (int i = 0; i < STRESS_VALUES; i++) {
+        value = args->first + i;
+        assert(stack_pool_combining_push(args->stack, &value) == STACK_OK);
+        if (i % 2 && stack_pool_combining_pop(args->stack, &value) == STACK_OK) {
+            __atomic_fetch_add(&args->seen[value], 1, __ATOMIC_RELAXED);
+        }
+    }
+    
+    while (stack_pool_combining_pop(args->stack, &value) == STACK_OK) {
+        __atomic_fetch_add(&args->seen[value], 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+void test_stack_pool_combining_stress() {
+    printf("Testing stack_pool_combining under contention...\n");
+    
+    StackPoolCombining* stack = NULL;
+    pthread_t threads[STRESS_THREADS];
+    StressArgs args[STRESS_THREADS];
+    size_t total = (size_t)STRESS_THREADS * STRESS_VALUES;
+    unsigned char* seen = calloc(total, 1);
+    size_t size = 1;
+    assert(seen != NULL);
+    
+    // Room for every value, so no push fails
+    assert(stack_pool_combining_init(&stack, total, sizeof(int)) == STACK_OK);
+    
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        args[t].stack = stack;
+        args[t].first = t * STRESS_VALUES;
+        args[t].seen = seen;
+        assert(pthread_create(&threads[t], NULL, stress_worker, &args[t]) == 0);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    
+    // Every value is popped exactly once
+    for (size_t i = 0; i < total; i++) {
+        assert(seen[i] == 1);
+    }
+    assert(stack_pool_combining_size(stack, &size) == STACK_OK);
+    assert(size == 0);
+    
+#ifdef STACK_ENABLE_STATS
+    // Requests matched within a pass count too
+    StackStats stats;
+    assert(stack_pool_combining_stats(stack, &stats) == STACK_OK);
+    assert(stats.pushes == total);
+    assert(stats.pops == total);
+    assert(stats.full_rejections == 0);
+#endif
+    
+    stack_pool_combining_destroy(stack);
+    free(seen);
+    printf("stack_pool_combining contention tests passed!\n\n");
+}
+
+#ifdef __linux__
+// Returns 1 if the descriptor is readable, without consuming the signal.
+static int fd_ready(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+#endif
+
+void test_stack_pool_combining_accounting() {
+    printf("Testing stack_pool_combining stats and events...\n");
+    
+    StackPoolCombining* stack = NULL;
+    StackStats stats;
+    StackLatency latency;
+    int value = 7;
+    int out = 0;
+    
+    assert(stack_pool_combining_init(&stack, 3, sizeof(int)) == STACK_OK);
+    assert(stack_pool_combining_stats(NULL, &stats) == STACK_NULL_PTR);
+    assert(stack_pool_combining_stats(stack, NULL) == STACK_NULL_OUT);
+    assert(stack_pool_combining_latency(NULL, STACK_TRACE_PUSH, &latency) == STACK_NULL_PTR);
+    assert(stack_pool_combining_event_open(NULL, 0, NULL) == STACK_NULL_PTR);
+    assert(stack_pool_combining_event_ack(NULL) == STACK_NULL_PTR);
+    assert(stack_pool_combining_event_close(NULL) == STACK_NULL_PTR);
+    
+#ifdef __linux__
+    int fd = -1;
+    
+    assert(stack_pool_combining_event_ack(stack) == STACK_INVALID_ARGS);
+    assert(stack_pool_combining_event_open(stack, 2, &fd) == STACK_OK);
+    assert(!fd_ready(fd));
+    
+    // Going from empty to non-empty signals
+    assert(stack_pool_combining_push(stack, &value) == STACK_OK);
+    assert(fd_ready(fd));
+    
+    uint64_t count = 0;
+    assert(read(fd, &count, sizeof(count)) == sizeof(count));
+    assert(stack_pool_combining_event_ack(stack) == STACK_OK);
+    assert(stack_pool_combining_push(stack, &value) == STACK_OK);
+    assert(stack_pool_combining_push(stack, &value) == STACK_OK);
+    assert(!fd_ready(fd));
+    
+    // Falling below the watermark signals
+    assert(stack_pool_combining_pop(stack, &out) == STACK_OK);
+    assert(!fd_ready(fd));
+    assert(stack_pool_combining_pop(stack, &out) == STACK_OK);
+    assert(fd_ready(fd));
+    assert(stack_pool_combining_pop(stack, &out) == STACK_OK);
+    assert(stack_pool_combining_event_close(stack) == STACK_OK);
+#endif
+    
+    stack_pool_combining_destroy(stack);
+    assert(stack_pool_combining_init(&stack, 3, sizeof(int)) == STACK_OK);
+    for (int i = 0; i < 4; i++) {
+        stack_pool_combining_push(stack, &value);
+    }
+    for (int i = 0; i < 4; i++) {
+        stack_pool_combining_pop(stack, &out);
+    }
+    assert(out == value);
+    
+#ifdef STACK_ENABLE_STATS
+    assert(stack_pool_combining_stats(stack, &stats) == STACK_OK);
+    assert(stats.pushes == 3);
+    assert(stats.pops == 3);
+    assert(stats.high_water == 3);
+    assert(stats.full_rejections == 1);
+    assert(stats.empty_rejections == 1);
+    assert(stats.bytes_copied == 6 * sizeof(int));
+#else
+    assert(stack_pool_combining_stats(stack, &stats) == STACK_UNKNOWN_ERROR);
+#endif
+    
+    stack_pool_combining_destroy(stack);
+    printf("stack_pool_combining stats and events tests passed!\n\n");
+}
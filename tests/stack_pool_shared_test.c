@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <stack_pool_shared.h>
+
+#define CHILD_VALUES 1000
+
+typedef struct {
+    int id;
+    char name[16];
+} TestStruct;
+
+void test_stack_pool_shared_init() {
+    printf("Testing stack_pool_shared create/attach...\n");
+    
+    char name[64];
+    StackPoolShared* stack = NULL;
+    StackPoolShared* other = NULL;
+    TestStruct item = {7, "shared"};
+    TestStruct out = {0, ""};
+    size_t size = 1;
+    
+    snprintf(name, sizeof(name), "/stack_pool_shared_test_%d", (int)getpid());
+    stack_pool_shared_unlink(name);
+    
+    // Invalid arguments
+    assert(stack_pool_shared_create(NULL, name, 4, sizeof(TestStruct)) == STACK_NULL_PTR);
+    assert(stack_pool_shared_create(&stack, name, 0, sizeof(TestStruct)) == STACK_INVALID_ARGS);
+    assert(stack_pool_shared_create(&stack, name, 4, 0) == STACK_INVALID_ARGS);
+    assert(stack_pool_shared_attach(&stack, NULL) == STACK_NULL_PTR);
+    assert(stack_pool_shared_attach(&stack, name) == STACK_ALLOC_FAILED);
+    assert(stack_pool_shared_unlink(name) == STACK_INVALID_ARGS);
+    
+    assert(stack_pool_shared_create(&stack, name, 4, sizeof(TestStruct)) == STACK_OK);
+    assert(stack_pool_shared_create(&other, name, 4, sizeof(TestStruct)) == STACK_ALLOC_FAILED);
+    assert(stack_pool_shared_attach(&other, name) == STACK_OK);
+    
+    // The second mapping sees the blocks at its own address
+    assert(other->header != stack->header);
+    assert(stack_pool_shared_pop(stack, &out) == STACK_EMPTY);
+    assert(stack_pool_shared_push(stack, NULL) == STACK_NULL_DATA);
+    assert(stack_pool_shared_pop(stack, NULL) == STACK_NULL_OUT);
+    for (int i = 0; i < 4; i++) {
+        item.id = i;
+        assert(stack_pool_shared_push(stack, &item) == STACK_OK);
+    }
+    assert(stack_pool_shared_push(other, &item) == STACK_FULL);
+    assert(stack_pool_shared_size(other, &size) == STACK_OK);
+    assert(size == 4);
+    assert(stack_pool_shared_pop(other, &out) == STACK_OK);
+    assert(out.id == 3);
+    assert(strcmp(out.name, "shared") == 0);
+    
+    assert(stack_pool_shared_detach(other) == STACK_OK);
+    assert(stack_pool_shared_detach(stack) == STACK_OK);
+    assert(stack_pool_shared_detach(NULL) == STACK_NULL_PTR);
+    
+    // The object outlives the handles until it is unlinked
+    assert(stack_pool_shared_attach(&stack, name) == STACK_OK);
+    assert(stack_pool_shared_size(stack, &size) == STACK_OK);
+    assert(size == 3);
+    assert(stack_pool_shared_detach(stack) == STACK_OK);
+    assert(stack_pool_shared_unlink(name) == STACK_OK);
+    
+    printf("stack_pool_shared create/attach tests passed!\n\n");
+}
+
+void test_stack_pool_shared_processes() {
+    printf("Testing stack_pool_shared across processes...\n");
+    
+    StackPoolShared* stack = NULL;
+    size_t size = 0;
+    int status = 0;
+    int value = 0;
+    long sum = 0;
+    
+    assert(stack_pool_shared_create(&stack, NULL, CHILD_VALUES, sizeof(int)) == STACK_OK);
+    
+    // A forked child pushes through the inherited mapping
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        for (int i = 1; i <= CHILD_VALUES; i++) {
+            if (stack_pool_shared_push(stack, &i) != STACK_OK)
+                _exit(1);
+        }
+        _exit(0);
+    }
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    
+    while (stack_pool_shared_pop(stack, &value) == STACK_OK) {
+        sum += value;
+    }
+    assert(sum == (long)CHILD_VALUES * (CHILD_VALUES + 1) / 2);
+    
+    // A child dies holding the lock, the parent recovers it
+    pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        pthread_mutex_lock(&stack->header->lock);
+        _exit(0);
+    }
+    assert(waitpid(pid, &status, 0) == pid);
+    
+    value = 42;
+    assert(stack_pool_shared_push(stack, &value) == STACK_OK);
+    assert(stack->header->owner_deaths == 1);
+    assert(stack_pool_shared_size(stack, &size) == STACK_OK);
+    assert(size == 1);
+    
+    stack_pool_shared_detach(stack);
+    printf("stack_pool_shared process tests passed!\n\n");
+}
@@ -2,7 +2,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
+#include <poll.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
 #include <stack_pool.h>
+#include <stack_fast.h>
 
 typedef struct {
     int id;
@@ -111,3 +119,704 @@ void test_stack_pool_clear_is_empty() {
     stack_pool_destroy(stack);
     printf("stack_pool clear/is_empty tests passed!\n\n");
 }
+
+void test_stack_pool_growth() {
+    printf("Testing stack_pool growth...\n");
+    
+    StackPool* stack = NULL;
+    StackPoolGrowth policies[] = {STACK_POOL_DOUBLE, STACK_POOL_SEGMENTED};
+    
+    // Invalid arguments
+    assert(stack_pool_init_growable(NULL, 4, sizeof(int), STACK_POOL_DOUBLE, 0) == STACK_NULL_PTR);
+    assert(stack_pool_init_growable(&stack, 0, sizeof(int), STACK_POOL_DOUBLE, 0) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_growable(&stack, 4, sizeof(int), STACK_POOL_DOUBLE, 2) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_growable(&stack, 4, sizeof(int), (StackPoolGrowth)42, 0) == STACK_INVALID_ARGS);
+    
+    for (size_t p = 0; p < 2; p++) {
+        assert(stack_pool_init_growable(&stack, 3, sizeof(int), policies[p], 50) == STACK_OK);
+        assert(stack->capacity == 3);
+        
+        // Grow up to the maximum capacity
+        for (int i = 0; i < 50; i++) {
+            assert(stack_pool_push(stack, &i) == STACK_OK);
+        }
+        assert(stack->size == 50);
+        assert(stack->capacity == 50);
+        
+        // The maximum capacity is a hard bound
+        int value = -1;
+        assert(stack_pool_push(stack, &value) == STACK_FULL);
+        
+        // Pop back across growth boundaries
+        int out = 0;
+        for (int i = 49; i >= 20; i--) {
+            assert(stack_pool_pop(stack, &out) == STACK_OK);
+            assert(out == i);
+        }
+        
+        // Push again into memory that already exists
+        for (int i = 20; i < 50; i++) {
+            assert(stack_pool_push(stack, &i) == STACK_OK);
+        }
+        assert(stack_pool_peek(stack, &out) == STACK_OK);
+        assert(out == 49);
+        
+        for (int i = 49; i >= 0; i--) {
+            assert(stack_pool_pop(stack, &out) == STACK_OK);
+            assert(out == i);
+        }
+        assert(stack_pool_pop(stack, &out) == STACK_EMPTY);
+        
+        // Refill after clearing
+        for (int i = 0; i < 10; i++) {
+            assert(stack_pool_push(stack, &i) == STACK_OK);
+        }
+        assert(stack_pool_clear(stack) == STACK_OK);
+        for (int i = 0; i < 10; i++) {
+            assert(stack_pool_push(stack, &i) == STACK_OK);
+        }
+        assert(stack_pool_pop(stack, &out) == STACK_OK);
+        assert(out == 9);
+        
+        stack_pool_destroy(stack);
+    }
+    
+    // Block addresses do not move in segmented mode
+    assert(stack_pool_init_growable(&stack, 2, sizeof(int), STACK_POOL_SEGMENTED, 0) == STACK_OK);
+    int first = 7;
+    assert(stack_pool_push(stack, &first) == STACK_OK);
+    void* bottom = stack->top;
+    for (int i = 0; i < 100; i++) {
+        assert(stack_pool_push(stack, &i) == STACK_OK);
+    }
+    assert(stack->segments[0].base == bottom);
+    assert(*(int*)bottom == first);
+    stack_pool_destroy(stack);
+    
+    printf("stack_pool growth tests passed!\n\n");
+}
+
+void test_stack_pool_block_sizes() {
+    printf("Testing stack_pool block sizes...\n");
+    
+    size_t sizes[] = {1, 2, 3, 4, 8, 16, 24, 32, 64, 65, 100, 512};
+    unsigned char in[512];
+    unsigned char out[512];
+    
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        StackPool* stack = NULL;
+        size_t block_size = sizes[s];
+        assert(stack_pool_init(&stack, 4, block_size) == STACK_OK);
+        
+        // Push blocks with distinct byte patterns
+        for (int n = 0; n < 4; n++) {
+            for (size_t i = 0; i < block_size; i++) {
+                in[i] = (unsigned char)(i * 7 + n);
+            }
+            assert(stack_pool_push(stack, in) == STACK_OK);
+        }
+        
+        // Peek does not touch bytes beyond the block
+        memset(out, 0xAB, sizeof(out));
+        assert(stack_pool_peek(stack, out) == STACK_OK);
+        for (size_t i = 0; i < block_size; i++) {
+            assert(out[i] == (unsigned char)(i * 7 + 3));
+        }
+        for (size_t i = block_size; i < sizeof(out); i++) {
+            assert(out[i] == 0xAB);
+        }
+        
+        // Pop in reverse order with identical contents
+        for (int n = 3; n >= 0; n--) {
+            assert(stack_pool_pop(stack, out) == STACK_OK);
+            for (size_t i = 0; i < block_size; i++) {
+                assert(out[i] == (unsigned char)(i * 7 + n));
+            }
+        }
+        
+        stack_pool_destroy(stack);
+    }
+    
+    printf("stack_pool block sizes tests passed!\n\n");
+}
+
+void test_stack_pool_push_pop_n() {
+    printf("Testing stack_pool push_n/pop_n...\n");
+    
+    StackPool* stack = NULL;
+    int values[100];
+    int out[100];
+    size_t done = 0;
+    
+    for (int i = 0; i < 100; i++) {
+        values[i] = i;
+    }
+    
+    // Partial push into a fixed pool
+    assert(stack_pool_init(&stack, 10, sizeof(int)) == STACK_OK);
+    assert(stack_pool_push_n(NULL, values, 5, &done) == STACK_NULL_PTR);
+    assert(stack_pool_push_n(stack, NULL, 5, &done) == STACK_NULL_DATA);
+    assert(stack_pool_push_n(stack, values, 4, &done) == STACK_OK);
+    assert(done == 4);
+    assert(stack_pool_push_n(stack, values + 4, 20, &done) == STACK_FULL);
+    assert(done == 6);
+    assert(stack->size == 10);
+    
+    int top = 0;
+    assert(stack_pool_peek(stack, &top) == STACK_OK);
+    assert(top == 9);
+    
+    // Pop keeps the stack order
+    assert(stack_pool_pop_n(stack, out, 3, &done) == STACK_OK);
+    assert(done == 3);
+    assert(out[0] == 7 && out[1] == 8 && out[2] == 9);
+    
+    // Pop more than available
+    assert(stack_pool_pop_n(stack, NULL, 3, &done) == STACK_NULL_OUT);
+    assert(stack_pool_pop_n(stack, out, 20, &done) == STACK_EMPTY);
+    assert(done == 7);
+    for (int i = 0; i < 7; i++) {
+        assert(out[i] == i);
+    }
+    assert(stack->size == 0);
+    
+    // Single operations still work after batches
+    assert(stack_pool_push(stack, &values[42]) == STACK_OK);
+    assert(stack_pool_pop(stack, &top) == STACK_OK);
+    assert(top == 42);
+    stack_pool_destroy(stack);
+    
+    // Batches across segments and reallocations
+    StackPoolGrowth policies[] = {STACK_POOL_DOUBLE, STACK_POOL_SEGMENTED};
+    for (size_t p = 0; p < 2; p++) {
+        assert(stack_pool_init_growable(&stack, 3, sizeof(int), policies[p], 0) == STACK_OK);
+        assert(stack_pool_push(stack, &values[0]) == STACK_OK);
+        assert(stack_pool_push_n(stack, values + 1, 99, &done) == STACK_OK);
+        assert(done == 99);
+        assert(stack->size == 100);
+        
+        assert(stack_pool_pop(stack, &top) == STACK_OK);
+        assert(top == 99);
+        assert(stack_pool_pop_n(stack, out, 50, NULL) == STACK_OK);
+        for (int i = 0; i < 50; i++) {
+            assert(out[i] == 49 + i);
+        }
+        assert(stack_pool_peek(stack, &top) == STACK_OK);
+        assert(top == 48);
+        
+        assert(stack_pool_push_n(stack, values + 49, 30, NULL) == STACK_OK);
+        assert(stack_pool_pop_n(stack, out, 100, &done) == STACK_EMPTY);
+        assert(done == 79);
+        for (int i = 0; i < 79; i++) {
+            assert(out[i] == i);
+        }
+        assert(stack_pool_pop(stack, &top) == STACK_EMPTY);
+        
+        stack_pool_destroy(stack);
+    }
+    
+    printf("stack_pool push_n/pop_n tests passed!\n\n");
+}
+
+void test_stack_pool_in_place() {
+    printf("Testing stack_pool in-place access...\n");
+    
+    StackPool* stack = NULL;
+    void* slot = NULL;
+    void* block = NULL;
+    TestStruct out_item;
+    
+    assert(stack_pool_init(&stack, 2, sizeof(TestStruct)) == STACK_OK);
+    
+    // Nothing to access in an empty stack
+    assert(stack_pool_top_ptr(stack, &block) == STACK_EMPTY);
+    assert(stack_pool_drop(stack) == STACK_EMPTY);
+    assert(stack_pool_push_slot(stack, NULL) == STACK_NULL_OUT);
+    assert(stack_pool_top_ptr(stack, NULL) == STACK_NULL_OUT);
+    
+    // Build elements in place
+    assert(stack_pool_push_slot(stack, &slot) == STACK_OK);
+    ((TestStruct*)slot)->id = 1;
+    strcpy(((TestStruct*)slot)->name, "Alice");
+    assert(stack->size == 1);
+    
+    assert(stack_pool_push_slot(stack, &slot) == STACK_OK);
+    ((TestStruct*)slot)->id = 2;
+    strcpy(((TestStruct*)slot)->name, "Bob");
+    assert(stack_pool_push_slot(stack, &slot) == STACK_FULL);
+    
+    // Read and modify the top without copying
+    assert(stack_pool_top_ptr(stack, &block) == STACK_OK);
+    assert(block == slot);
+    assert(((TestStruct*)block)->id == 2);
+    ((TestStruct*)block)->id = 20;
+    
+    assert(stack_pool_peek(stack, &out_item) == STACK_OK);
+    assert(out_item.id == 20);
+    assert(strcmp(out_item.name, "Bob") == 0);
+    
+    // Discard the top
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack->size == 1);
+    assert(stack_pool_top_ptr(stack, &block) == STACK_OK);
+    assert(((TestStruct*)block)->id == 1);
+    
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack->size == 0);
+    assert(stack_pool_pop(stack, &out_item) == STACK_EMPTY);
+    
+    stack_pool_destroy(stack);
+    
+    // Slots across segments
+    assert(stack_pool_init_growable(&stack, 2, sizeof(int), STACK_POOL_SEGMENTED, 0) == STACK_OK);
+    for (int i = 0; i < 10; i++) {
+        assert(stack_pool_push_slot(stack, &slot) == STACK_OK);
+        *(int*)slot = i;
+    }
+    for (int i = 9; i >= 5; i--) {
+        assert(stack_pool_top_ptr(stack, &block) == STACK_OK);
+        assert(*(int*)block == i);
+        assert(stack_pool_drop(stack) == STACK_OK);
+    }
+    int value = 0;
+    assert(stack_pool_pop(stack, &value) == STACK_OK);
+    assert(value == 4);
+    stack_pool_destroy(stack);
+    
+    printf("stack_pool in-place access tests passed!\n\n");
+}
+
+static void* empty_pop_worker(void* arg) {
+    StackPool* stack = arg;
+    int out = 0;
+    
+    assert(stack_pool_pop(stack, &out) == STACK_EMPTY);
+#ifndef STACK_NO_LAST_ERROR
+    assert(stack_get_last_error() == STACK_EMPTY);
+#endif
+    return NULL;
+}
+
+void test_stack_pool_last_error_per_thread() {
+    printf("Testing per-thread last error...\n");
+    
+    StackPool* stack = NULL;
+    StackPool* other = NULL;
+    pthread_t thread;
+    
+    assert(stack_pool_init(&stack, 2, sizeof(int)) == STACK_OK);
+    assert(stack_pool_init(&other, 2, sizeof(int)) == STACK_OK);
+    
+    // An error in another thread does not change this thread's error
+    assert(stack_pool_size(stack, NULL) == STACK_NULL_OUT);
+    assert(pthread_create(&thread, NULL, empty_pop_worker, other) == 0);
+    pthread_join(thread, NULL);
+#ifndef STACK_NO_LAST_ERROR
+    assert(stack_get_last_error() == STACK_NULL_OUT);
+#endif
+    
+    stack_pool_destroy(stack);
+    stack_pool_destroy(other);
+    printf("per-thread last error tests passed!\n\n");
+}
+
+void test_stack_pool_unchecked() {
+    printf("Testing stack_pool unchecked operations...\n");
+    
+    StackPoolGrowth policies[] = {STACK_POOL_FIXED, STACK_POOL_DOUBLE, STACK_POOL_SEGMENTED};
+    
+    for (size_t p = 0; p < 3; p++) {
+        StackPool* stack = NULL;
+        size_t capacity = policies[p] == STACK_POOL_FIXED ? 40 : 3;
+        int out = 0;
+        
+        assert(stack_pool_init_growable(&stack, capacity, sizeof(int), policies[p], 40) == STACK_OK);
+        assert(stack_pool_pop_unchecked(stack, &out) == STACK_EMPTY);
+        assert(stack_pool_peek_unchecked(stack, &out) == STACK_EMPTY);
+        
+        // Mix checked and unchecked pushes across growth boundaries
+        for (int i = 0; i < 40; i++) {
+            if (i % 3)
+                assert(stack_pool_push_unchecked(stack, &i) == STACK_OK);
+            else
+                assert(stack_pool_push(stack, &i) == STACK_OK);
+        }
+        assert(stack_pool_size_unchecked(stack) == 40);
+        assert(stack_pool_push_unchecked(stack, &out) == STACK_FULL);
+        
+        assert(stack_pool_peek_unchecked(stack, &out) == STACK_OK);
+        assert(out == 39);
+        
+        for (int i = 39; i >= 0; i--) {
+            if (i % 2)
+                assert(stack_pool_pop_unchecked(stack, &out) == STACK_OK);
+            else
+                assert(stack_pool_pop(stack, &out) == STACK_OK);
+            assert(out == i);
+        }
+        assert(stack_pool_size_unchecked(stack) == 0);
+        assert(stack_pool_pop_unchecked(stack, &out) == STACK_EMPTY);
+        
+        stack_pool_destroy(stack);
+    }
+    
+    printf("stack_pool unchecked operations tests passed!\n\n");
+}
+
+#ifdef __linux__
+// Returns 1 if the descriptor is readable, without consuming the signal.
+static int fd_ready(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+#endif
+
+void test_stack_pool_events() {
+    printf("Testing stack_pool readiness descriptor...\n");
+    
+#ifdef __linux__
+    StackPool* stack = NULL;
+    int fd = -1;
+    int value = 1;
+    int out = 0;
+    int blocks[4] = {0};
+    
+    assert(stack_pool_init(&stack, 8, sizeof(int)) == STACK_OK);
+    assert(stack->event.fd == -1);
+    assert(stack_pool_event_ack(stack) == STACK_INVALID_ARGS);
+    assert(stack_pool_event_open(stack, 2, NULL) == STACK_NULL_OUT);
+    assert(stack_pool_event_open(stack, 2, &fd) == STACK_OK);
+    assert(fd >= 0);
+    assert(!fd_ready(fd));
+    
+    // A burst of pushes signals once
+    for (int i = 0; i < 4; i++) {
+        assert(stack_pool_push(stack, &value) == STACK_OK);
+    }
+    assert(fd_ready(fd));
+    assert(stack->event.armed == false);
+    
+    uint64_t count = 0;
+    assert(read(fd, &count, sizeof(count)) == sizeof(count));
+    assert(count == 1);
+    assert(stack_pool_event_ack(stack) == STACK_OK);
+    assert(!fd_ready(fd));
+    
+    // Popping to 3 stays above the watermark, 1 falls below it
+    assert(stack_pool_pop(stack, &out) == STACK_OK);
+    assert(!fd_ready(fd));
+    assert(stack_pool_pop_n(stack, blocks, 2, NULL) == STACK_OK);
+    assert(fd_ready(fd));
+    assert(stack_pool_event_ack(stack) == STACK_OK);
+    assert(!fd_ready(fd));
+    
+    // Clearing and refilling through the other entry points
+    assert(stack_pool_clear(stack) == STACK_OK);
+    assert(!fd_ready(fd));
+    assert(stack_pool_push_n(stack, blocks, 4, NULL) == STACK_OK);
+    assert(fd_ready(fd));
+    assert(stack_pool_event_ack(stack) == STACK_OK);
+    assert(stack_pool_push_unchecked(stack, &value) == STACK_OK);
+    assert(stack_pool_pop_unchecked(stack, &out) == STACK_OK);
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(fd_ready(fd));
+    
+    assert(stack_pool_event_close(stack) == STACK_OK);
+    assert(stack->event.fd == -1);
+    stack_pool_destroy(stack);
+#endif
+    
+    printf("stack_pool readiness descriptor tests passed!\n\n");
+}
+
+void test_stack_pool_persistent() {
+    printf("Testing persistent stack_pool...\n");
+    
+    char path[64];
+    StackPool* stack = NULL;
+    TestStruct item = {0, ""};
+    TestStruct out = {0, ""};
+    
+    snprintf(path, sizeof(path), "/tmp/stack_pool_test_%d.bin", (int)getpid());
+    unlink(path);
+    
+    // Invalid arguments
+    assert(stack_pool_open(NULL, path, 8, sizeof(TestStruct)) == STACK_NULL_PTR);
+    assert(stack_pool_open(&stack, NULL, 8, sizeof(TestStruct)) == STACK_NULL_PTR);
+    assert(stack_pool_open(&stack, path, 0, sizeof(TestStruct)) == STACK_INVALID_ARGS);
+    assert(stack_pool_open(&stack, path, SIZE_MAX / 2, sizeof(TestStruct)) == STACK_INVALID_ARGS);
+    // A rejected open leaves no file behind
+    assert(access(path, F_OK) != 0);
+    
+    // A new file, synced twice
+    assert(stack_pool_open(&stack, path, 8, sizeof(TestStruct)) == STACK_OK);
+    assert(stack->storage == STACK_POOL_FILE);
+    assert(stack->capacity == 8);
+    assert(stack->size == 0);
+    for (int i = 0; i < 5; i++) {
+        item.id = i;
+        snprintf(item.name, sizeof(item.name), "item%d", i);
+        assert(stack_pool_push(stack, &item) == STACK_OK);
+    }
+    assert(stack_pool_sync(stack) == STACK_OK);
+    assert(stack_pool_pop(stack, &out) == STACK_OK);
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    // Reattach with the block size taken from the file
+    assert(stack_pool_open(&stack, path, 0, 0) == STACK_OK);
+    assert(stack->block_size == sizeof(TestStruct));
+    assert(stack->capacity == 8);
+    assert(stack->size == 4);
+    assert(stack_pool_peek(stack, &out) == STACK_OK);
+    assert(out.id == 3);
+    assert(strcmp(out.name, "item3") == 0);
+    assert(stack_pool_push(stack, &item) == STACK_OK);
+    assert(stack_pool_sync(stack) == STACK_OK);
+    assert(stack_pool_pop_n(stack, NULL, 0, NULL) == STACK_OK);
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    assert(stack_pool_open(&stack, path, 8, sizeof(int)) == STACK_INVALID_ARGS);
+    
+    // A torn newest header falls back to the previous sync
+    int fd = open(path, O_RDWR);
+    assert(fd >= 0);
+    for (off_t slot = 0; slot < 1024; slot += 512) {
+        uint64_t sequence = 0;
+        assert(pread(fd, &sequence, sizeof(sequence), slot + 8) == sizeof(sequence));
+        if (sequence == 5) {
+            uint64_t garbage = 0;
+            assert(pwrite(fd, &garbage, sizeof(garbage), slot + 32) == sizeof(garbage));
+        }
+    }
+    assert(stack_pool_open(&stack, path, 0, sizeof(TestStruct)) == STACK_OK);
+    assert(stack->size == 5);
+    assert(stack_pool_pop(stack, &out) == STACK_OK);
+    assert(out.id == 4);
+    stack_pool_destroy(stack);
+    
+    // Both headers damaged
+    char zeros[1024] = {0};
+    assert(pwrite(fd, zeros, sizeof(zeros), 0) == sizeof(zeros));
+    close(fd);
+    assert(stack_pool_open(&stack, path, 8, sizeof(TestStruct)) == STACK_INVALID_TYPE);
+    unlink(path);
+    
+    // Only mapped pools can be synced
+    assert(stack_pool_init(&stack, 4, sizeof(int)) == STACK_OK);
+    assert(stack_pool_sync(stack) == STACK_INVALID_TYPE);
+    assert(stack_pool_sync(NULL) == STACK_NULL_PTR);
+    stack_pool_destroy(stack);
+    
+    printf("persistent stack_pool tests passed!\n\n");
+}
+
+void test_stack_pool_spill() {
+    printf("Testing spilling stack_pool...\n");
+    
+    StackPool* stack = NULL;
+    int values[64];
+    int out[64];
+    int value = 0;
+    size_t count = 0;
+    
+    // Invalid arguments
+    assert(stack_pool_init_spill(NULL, 8, sizeof(int), NULL) == STACK_NULL_PTR);
+    assert(stack_pool_init_spill(&stack, 1, sizeof(int), NULL) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_spill(&stack, 8, 0, NULL) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_spill(&stack, 8, sizeof(int), "/nonexistent/dir") == STACK_ALLOC_FAILED);
+    
+    // Ten times the memory capacity, in LIFO order
+    assert(stack_pool_init_spill(&stack, 8, sizeof(int), NULL) == STACK_OK);
+    assert(stack->growth == STACK_POOL_SPILL);
+    for (int i = 0; i < 80; i++) {
+        assert(stack_pool_push(stack, &i) == STACK_OK);
+        assert(stack->size <= 8);
+    }
+    assert(stack_pool_size(stack, &count) == STACK_OK);
+    assert(count == 80);
+    assert(stack_pool_size_unchecked(stack) == 80);
+    assert(stack->spilled >= 72);
+    
+    for (int i = 79; i >= 0; i--) {
+        assert(stack_pool_peek(stack, &value) == STACK_OK);
+        assert(value == i);
+        assert(stack_pool_pop(stack, &value) == STACK_OK);
+        assert(value == i);
+    }
+    assert(stack->spilled == 0);
+    assert(stack_pool_pop(stack, &value) == STACK_EMPTY);
+    
+    // Batches and unchecked operations across the file
+    for (int i = 0; i < 64; i++)
+        values[i] = i;
+    assert(stack_pool_push_n(stack, values, 64, &count) == STACK_OK);
+    assert(count == 64);
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack_pool_pop_n(stack, out, 40, &count) == STACK_OK);
+    assert(count == 40);
+    for (int i = 0; i < 40; i++)
+        assert(out[i] == 23 + i);
+    for (int i = 100; i < 120; i++)
+        assert(stack_pool_push_unchecked(stack, &i) == STACK_OK);
+    for (int i = 119; i >= 100; i--) {
+        assert(stack_pool_pop_unchecked(stack, &value) == STACK_OK);
+        assert(value == i);
+    }
+    assert(stack_pool_pop_n(stack, out, 64, &count) == STACK_EMPTY);
+    assert(count == 23);
+    for (int i = 0; i < 23; i++)
+        assert(out[i] == i);
+    
+    // Clearing discards the spilled blocks
+    assert(stack_pool_push_n(stack, values, 64, NULL) == STACK_OK);
+    assert(stack_pool_clear(stack) == STACK_OK);
+    assert(stack_pool_size(stack, &count) == STACK_OK);
+    assert(count == 0);
+    assert(stack_pool_push(stack, &values[5]) == STACK_OK);
+    assert(stack_pool_pop(stack, &value) == STACK_OK);
+    assert(value == 5);
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    printf("spilling stack_pool tests passed!\n\n");
+}
+
+static void guard_page_hit(int sig) {
+    (void)sig;
+    _exit(3);
+}
+
+void test_stack_pool_reserved() {
+    printf("Testing reserved stack_pool...\n");
+    
+    StackPool* stack = NULL;
+    size_t step = 64 * 1024 / sizeof(int);
+    size_t capacity = 8 * step;
+    int value = 0;
+    
+    // Invalid arguments
+    assert(stack_pool_init_reserved(NULL, 8, sizeof(int), 0) == STACK_NULL_PTR);
+    assert(stack_pool_init_reserved(&stack, 0, sizeof(int), 0) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_reserved(&stack, 8, 0, 0) == STACK_INVALID_ARGS);
+    
+    // Pages are committed one step at a time
+    assert(stack_pool_init_reserved(&stack, capacity, sizeof(int), 0) == STACK_OK);
+    assert(stack->storage == STACK_POOL_RESERVED);
+    assert((char*)stack->end - (char*)stack->pool == (ptrdiff_t)(step * sizeof(int)));
+    for (int i = 0; i < (int)capacity; i++)
+        assert(stack_pool_push(stack, &i) == STACK_OK);
+    assert((char*)stack->end - (char*)stack->pool == (ptrdiff_t)(capacity * sizeof(int)));
+    assert(stack_pool_push(stack, &value) == STACK_FULL);
+    
+    // Shrinking returns the pages above the size
+    for (int i = (int)capacity - 1; i >= (int)step; i--) {
+        assert(stack_pool_pop(stack, &value) == STACK_OK);
+        assert(value == i);
+    }
+    assert((char*)stack->end - (char*)stack->pool == (ptrdiff_t)(3 * step * sizeof(int)));
+    for (int i = (int)step; i < (int)(4 * step); i++)
+        assert(stack_pool_push(stack, &i) == STACK_OK);
+    for (int i = (int)(4 * step) - 1; i >= 0; i--) {
+        assert(stack_pool_pop(stack, &value) == STACK_OK);
+        assert(value == i);
+    }
+    assert(stack_pool_pop(stack, &value) == STACK_EMPTY);
+    assert((char*)stack->end - (char*)stack->pool == (ptrdiff_t)(2 * step * sizeof(int)));
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    // The high-water mark keeps its pages through a clear
+    assert(stack_pool_init_reserved(&stack, capacity, sizeof(int), 4 * step) == STACK_OK);
+    for (int i = 0; i < (int)capacity; i++)
+        assert(stack_pool_push(stack, &i) == STACK_OK);
+    assert(stack_pool_clear(stack) == STACK_OK);
+    assert((char*)stack->end - (char*)stack->pool == (ptrdiff_t)(6 * step * sizeof(int)));
+    assert(stack_pool_push(stack, &value) == STACK_OK);
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    // Writing past the last block hits the guard page
+    assert(stack_pool_init_reserved(&stack, 1024, 4096, 0) == STACK_OK);
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        void* slot = NULL;
+        signal(SIGSEGV, guard_page_hit);
+        while (stack_pool_push_slot(stack, &slot) == STACK_OK)
+            memset(slot, 1, 4096);
+        ((volatile char*)slot)[4096] = 1;
+        _exit(0);
+    }
+    int status = 0;
+    assert(waitpid(child, &status, 0) == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 3);
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    printf("reserved stack_pool tests passed!\n\n");
+}
+
+void test_stack_pool_aligned() {
+    printf("Testing aligned stack_pool...\n");
+    
+    typedef struct {
+        double values[3];
+    } Record;
+    
+    StackPool* stack = NULL;
+    Record records[40];
+    Record out[40];
+    Record record;
+    void* block = NULL;
+    size_t count = 0;
+    
+    // Invalid arguments
+    assert(stack_pool_init_aligned(NULL, 8, sizeof(Record), 64, STACK_POOL_PAGES_DEFAULT) == STACK_NULL_PTR);
+    assert(stack_pool_init_aligned(&stack, 0, sizeof(Record), 64, STACK_POOL_PAGES_DEFAULT) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_aligned(&stack, 8, 0, 64, STACK_POOL_PAGES_DEFAULT) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_aligned(&stack, 8, sizeof(Record), 48, STACK_POOL_PAGES_DEFAULT) == STACK_INVALID_ARGS);
+    assert(stack_pool_init_aligned(&stack, 8, sizeof(Record), 64, (StackPoolPages)7) == STACK_INVALID_ARGS);
+    
+    // Every block starts a cache line
+    assert(stack_pool_init_aligned(&stack, 40, sizeof(Record), 64, STACK_POOL_PAGES_DEFAULT) == STACK_OK);
+    assert(stack->stride == 64);
+    for (int i = 0; i < 40; i++) {
+        for (int j = 0; j < 3; j++)
+            records[i].values[j] = i * 3 + j;
+    }
+    for (int i = 0; i < 10; i++) {
+        assert(stack_pool_push(stack, &records[i]) == STACK_OK);
+        assert(stack_pool_top_ptr(stack, &block) == STACK_OK);
+        assert((uintptr_t)block % 64 == 0);
+    }
+    assert(stack_pool_push_n(stack, &records[10], 30, &count) == STACK_OK);
+    assert(count == 30);
+    assert(stack_pool_push(stack, &record) == STACK_FULL);
+    assert(stack_pool_pop(stack, &record) == STACK_OK);
+    assert(memcmp(&record, &records[39], sizeof(Record)) == 0);
+    assert(stack_pool_pop_n(stack, out, 40, &count) == STACK_EMPTY);
+    assert(count == 39);
+    assert(memcmp(out, records, 39 * sizeof(Record)) == 0);
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    // No alignment packs the blocks
+    assert(stack_pool_init_aligned(&stack, 8, sizeof(Record), 0, STACK_POOL_PAGES_DEFAULT) == STACK_OK);
+    assert(stack->stride == sizeof(Record));
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    // Huge pages: transparent ones are a hint, explicit ones may not be reserved
+    assert(stack_pool_init_aligned(&stack, 1 << 16, sizeof(Record), 64, STACK_POOL_PAGES_TRANSPARENT) == STACK_OK);
+    assert((uintptr_t)stack->pool % (2u << 20) == 0);
+    assert(stack_pool_push(stack, &records[0]) == STACK_OK);
+    assert(stack_pool_destroy(stack) == STACK_OK);
+    
+    StackError err = stack_pool_init_aligned(&stack, 1 << 16, sizeof(Record), 64, STACK_POOL_PAGES_HUGETLB);
+    assert(err == STACK_OK || err == STACK_ALLOC_FAILED);
+    if (err == STACK_OK) {
+        assert(stack->storage == STACK_POOL_ANONYMOUS);
+        assert(stack_pool_push(stack, &records[0]) == STACK_OK);
+        assert(stack_pool_destroy(stack) == STACK_OK);
+    }
+    
+    printf("aligned stack_pool tests passed!\n\n");
+}
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stack_pool.h>
+#include <stack_dyn.h>
+#include <stack_fast.h>
+#include <stack_stats.h>
+
+void test_stack_stats_pool() {
+    printf("Testing stack_pool_stats...\n");
+    
+    StackPool* stack = NULL;
+    StackStats stats;
+    int values[4] = {1, 2, 3, 4};
+    int out[4];
+    
+    assert(stack_pool_init(&stack, 4, sizeof(int)) == STACK_OK);
+    assert(stack_pool_stats(NULL, &stats) == STACK_NULL_PTR);
+    assert(stack_pool_stats(stack, NULL) == STACK_NULL_OUT);
+    
+#ifdef STACK_ENABLE_STATS
+    assert(stack_pool_stats(stack, &stats) == STACK_OK);
+    assert(stats.pushes == 0 && stats.pops == 0);
+    assert(stats.allocations == 1);
+    
+    assert(stack_pool_pop(stack, out) == STACK_EMPTY);
+    assert(stack_pool_push(stack, &values[0]) == STACK_OK);
+    assert(stack_pool_push_unchecked(stack, &values[1]) == STACK_OK);
+    assert(stack_pool_push_n(stack, &values[2], 2, NULL) == STACK_OK);
+    assert(stack_pool_push(stack, &values[0]) == STACK_FULL);
+    assert(stack_pool_pop_unchecked(stack, out) == STACK_OK);
+    assert(stack_pool_drop(stack) == STACK_OK);
+    assert(stack_pool_pop_n(stack, out, 3, NULL) == STACK_EMPTY);
+    
+    assert(stack_pool_stats(stack, &stats) == STACK_OK);
+    assert(stats.pushes == 4);
+    assert(stats.pops == 4);
+    assert(stats.high_water == 4);
+    assert(stats.full_rejections == 1);
+    assert(stats.empty_rejections == 2);
+    // The dropped block is not copied
+    assert(stats.bytes_copied == 7 * sizeof(int));
+    stack_pool_destroy(stack);
+    
+    // Growing counts an allocation
+    assert(stack_pool_init_growable(&stack, 2, sizeof(int), STACK_POOL_DOUBLE, 8) == STACK_OK);
+    for (int i = 0; i < 4; i++)
+        assert(stack_pool_push(stack, &values[i]) == STACK_OK);
+    assert(stack_pool_stats(stack, &stats) == STACK_OK);
+    assert(stats.allocations == 2);
+    assert(stats.high_water == 4);
+#else
+    assert(stack_pool_stats(stack, &stats) == STACK_UNKNOWN_ERROR);
+    (void)values;
+    (void)out;
+#endif
+    
+    stack_pool_destroy(stack);
+    
+    printf("stack_pool_stats tests passed!\n\n");
+}
+
+void test_stack_stats_dyn() {
+    printf("Testing stack_dyn_stats...\n");
+    
+    StackDyn* stack = NULL;
+    StackStats stats;
+    int values[3] = {1, 2, 3};
+    void* out[3];
+    
+    assert(stack_dyn_init(&stack, NULL, NULL) == STACK_OK);
+    assert(stack_dyn_stats(NULL, &stats) == STACK_NULL_PTR);
+    assert(stack_dyn_stats(stack, NULL) == STACK_NULL_OUT);
+    
+#ifdef STACK_ENABLE_STATS
+    void* data[3] = {&values[0], &values[1], &values[2]};
+    
+    assert(stack_dyn_push(stack, data[0]) == STACK_OK);
+    assert(stack_dyn_push_unchecked(stack, data[1]) == STACK_OK);
+    assert(stack_dyn_pop_unchecked(stack, &out[0]) == STACK_OK);
+    assert(stack_dyn_push_n(stack, data, 3, NULL) == STACK_OK);
+    assert(stack_dyn_pop_n(stack, out, 3, NULL) == STACK_OK);
+    assert(stack_dyn_pop(stack, &out[0]) == STACK_OK);
+    assert(stack_dyn_pop(stack, &out[0]) == STACK_EMPTY);
+    
+    assert(stack_dyn_stats(stack, &stats) == STACK_OK);
+    assert(stats.pushes == 5);
+    assert(stats.pops == 5);
+    assert(stats.high_water == 4);
+    assert(stats.full_rejections == 0);
+    assert(stats.empty_rejections == 1);
+    assert(stats.bytes_copied == 0);
+    // The stack and its first slab
+    assert(stats.allocations == 2);
+#else
+    assert(stack_dyn_stats(stack, &stats) == STACK_UNKNOWN_ERROR);
+    (void)values;
+    (void)out;
+#endif
+    
+    stack_dyn_destroy(stack);
+    
+    printf("stack_dyn_stats tests passed!\n\n");
+}
+
+void test_stack_stats_dump() {
+    printf("Testing stack_stats_dump...\n");
+    
+    StackPool* pool = NULL;
+    StackDyn* dyn = NULL;
+    char buffer[2048];
+    char id[64];
+    int value = 5;
+    
+    assert(stack_stats_dump(NULL, STACK_STATS_TEXT) == STACK_NULL_PTR);
+    assert(stack_stats_dump(stdout, (StackStatsFormat)7) == STACK_INVALID_ARGS);
+    
+    assert(stack_pool_init(&pool, 4, sizeof(int)) == STACK_OK);
+    assert(stack_dyn_init(&dyn, NULL, NULL) == STACK_OK);
+    assert(stack_pool_push(pool, &value) == STACK_OK);
+    
+    FILE* text = fmemopen(buffer, sizeof(buffer), "w");
+    assert(text != NULL);
+#ifdef STACK_ENABLE_STATS
+    assert(stack_stats_dump(text, STACK_STATS_TEXT) == STACK_OK);
+    fclose(text);
+    assert(strstr(buffer, "kind=pool") != NULL);
+    assert(strstr(buffer, "kind=dyn") != NULL);
+    assert(strstr(buffer, "pushes=1") != NULL);
+    // Rows are identified by the address of the stack
+    snprintf(id, sizeof(id), "id=%p ", (void*)pool);
+    assert(strstr(buffer, id) != NULL);
+    
+    FILE* json = fmemopen(buffer, sizeof(buffer), "w");
+    assert(json != NULL);
+    assert(stack_stats_dump(json, STACK_STATS_JSON) == STACK_OK);
+    fclose(json);
+    assert(buffer[0] == '[');
+    assert(strstr(buffer, "\"kind\": \"pool\"") != NULL);
+    assert(strstr(buffer, "\"kind\": \"dyn\"") != NULL);
+    
+    // Destroyed stacks leave the registry
+    stack_dyn_destroy(dyn);
+    text = fmemopen(buffer, sizeof(buffer), "w");
+    assert(stack_stats_dump(text, STACK_STATS_TEXT) == STACK_OK);
+    fclose(text);
+    assert(strstr(buffer, "kind=dyn") == NULL);
+#else
+    assert(stack_stats_dump(text, STACK_STATS_TEXT) == STACK_UNKNOWN_ERROR);
+    fclose(text);
+    stack_dyn_destroy(dyn);
+    (void)id;
+#endif
+    
+    stack_pool_destroy(pool);
+    
+    printf("stack_stats_dump tests passed!\n\n");
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stack_pool.h>
+#include <stack_dyn.h>
+#include <stack_fast.h>
+#include <stack_trace.h>
+
+#define TRACE_OPS 1000
+
+static void check_latency(const StackLatency* latency, size_t samples) {
+    assert(latency->samples == samples);
+    assert(latency->p50 <= latency->p99);
+    assert(latency->p99 <= latency->p999);
+    assert(latency->p999 <= latency->max);
+}
+
+void test_stack_trace_pool() {
+    printf("Testing stack_pool_latency...\n");
+    
+    StackPool* stack = NULL;
+    StackLatency latency;
+    size_t rate = 1;
+    int value = 0;
+    
+    assert(stack_pool_init(&stack, 4 * TRACE_OPS, sizeof(int)) == STACK_OK);
+    assert(stack_pool_latency(NULL, STACK_TRACE_PUSH, &latency) == STACK_NULL_PTR);
+    assert(stack_pool_latency(stack, STACK_TRACE_OPS, &latency) == STACK_INVALID_ARGS);
+    assert(stack_pool_latency(stack, STACK_TRACE_PUSH, NULL) == STACK_NULL_OUT);
+    assert(stack_trace_get_rate(NULL) == STACK_NULL_OUT);
+    
+#ifdef STACK_ENABLE_TRACE
+    assert(stack_trace_get_rate(&rate) == STACK_OK);
+    assert(rate == 0);
+    
+    // Nothing is sampled by default, the rate is reread every 1024 operations
+    assert(stack_trace_set_rate(1) == STACK_OK);
+    assert(stack_trace_set_rate(0) == STACK_OK);
+    assert(stack_pool_push(stack, &value) == STACK_OK);
+    assert(stack_trace_set_rate(1) == STACK_OK);
+    for (int i = 1; i < 1024; i++)
+        assert(stack_pool_push_unchecked(stack, &value) == STACK_OK);
+    assert(stack_pool_latency(stack, STACK_TRACE_PUSH, &latency) == STACK_OK);
+    check_latency(&latency, 0);
+    assert(latency.max == 0);
+    
+    // Every operation, checked or not, is timed at rate 1
+    for (int i = 0; i < TRACE_OPS; i++)
+        assert(stack_pool_push_unchecked(stack, &value) == STACK_OK);
+    for (int i = 0; i < TRACE_OPS; i++)
+        assert(stack_pool_pop_unchecked(stack, &value) == STACK_OK);
+    assert(stack_pool_clear(stack) == STACK_OK);
+    assert(stack_pool_latency(stack, STACK_TRACE_PUSH, &latency) == STACK_OK);
+    check_latency(&latency, TRACE_OPS);
+    assert(stack_pool_latency(stack, STACK_TRACE_POP, &latency) == STACK_OK);
+    check_latency(&latency, TRACE_OPS);
+    assert(stack_pool_latency(stack, STACK_TRACE_CLEAR, &latency) == STACK_OK);
+    check_latency(&latency, 1);
+    
+    // Failed operations are not timed
+    assert(stack_pool_pop(stack, &value) == STACK_EMPTY);
+    assert(stack_pool_latency(stack, STACK_TRACE_POP, &latency) == STACK_OK);
+    check_latency(&latency, TRACE_OPS);
+    
+    // One operation in ten
+    assert(stack_trace_set_rate(10) == STACK_OK);
+    for (int i = 0; i < TRACE_OPS; i++)
+        assert(stack_pool_push(stack, &value) == STACK_OK);
+    assert(stack_pool_latency(stack, STACK_TRACE_PUSH, &latency) == STACK_OK);
+    check_latency(&latency, TRACE_OPS + TRACE_OPS / 10);
+    
+    assert(stack_trace_set_rate(0) == STACK_OK);
+#else
+    assert(stack_pool_latency(stack, STACK_TRACE_PUSH, &latency) == STACK_UNKNOWN_ERROR);
+    assert(stack_trace_set_rate(1) == STACK_UNKNOWN_ERROR);
+    assert(stack_trace_get_rate(&rate) == STACK_UNKNOWN_ERROR);
+    (void)value;
+    (void)check_latency;
+#endif
+    
+    stack_pool_destroy(stack);
+    
+    printf("stack_pool_latency tests passed!\n\n");
+}
+
+void test_stack_trace_dyn() {
+    printf("Testing stack_dyn_latency...\n");
+    
+    StackDyn* stack = NULL;
+    StackLatency latency;
+    int value = 0;
+    void* out = NULL;
+    
+    assert(stack_dyn_init(&stack, NULL, NULL) == STACK_OK);
+    assert(stack_dyn_latency(NULL, STACK_TRACE_PUSH, &latency) == STACK_NULL_PTR);
+    assert(stack_dyn_latency(stack, STACK_TRACE_OPS, &latency) == STACK_INVALID_ARGS);
+    assert(stack_dyn_latency(stack, STACK_TRACE_POP, NULL) == STACK_NULL_OUT);
+    
+#ifdef STACK_ENABLE_TRACE
+    assert(stack_trace_set_rate(1) == STACK_OK);
+    
+    // The new stack reads the rate at its first operation
+    for (int i = 0; i < TRACE_OPS; i++)
+        assert(stack_dyn_push_unchecked(stack, &value) == STACK_OK);
+    for (int i = 0; i < TRACE_OPS / 2; i++)
+        assert(stack_dyn_pop(stack, &out) == STACK_OK);
+    assert(stack_dyn_clear(stack) == STACK_OK);
+    
+    assert(stack_dyn_latency(stack, STACK_TRACE_PUSH, &latency) == STACK_OK);
+    check_latency(&latency, TRACE_OPS);
+    assert(stack_dyn_latency(stack, STACK_TRACE_POP, &latency) == STACK_OK);
+    check_latency(&latency, TRACE_OPS / 2);
+    assert(stack_dyn_latency(stack, STACK_TRACE_CLEAR, &latency) == STACK_OK);
+    check_latency(&latency, 1);
+    
+    assert(stack_trace_set_rate(0) == STACK_OK);
+#else
+    assert(stack_dyn_latency(stack, STACK_TRACE_PUSH, &latency) == STACK_UNKNOWN_ERROR);
+    (void)value;
+    (void)out;
+#endif
+    
+    stack_dyn_destroy(stack);
+    
+    printf("stack_dyn_latency tests passed!\n\n");
+}
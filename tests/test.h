@@ -1,7 +1,60 @@
 void test_stack_dyn_init(void);
 void test_stack_dyn_push_pop(void);
 void test_stack_dyn_clear_is_empty(void);
+void test_stack_dyn_slab_reuse(void);
+void test_stack_dyn_chunked(void);
+void test_stack_dyn_push_pop_n(void);
+void test_stack_dyn_unchecked(void);
+void test_stack_dyn_events(void);
+void test_stack_dyn_sized(void);
 
 void test_stack_pool_init(void);
 void test_stack_pool_push_pop(void);
 void test_stack_pool_clear_is_empty(void);
+void test_stack_pool_growth(void);
+void test_stack_pool_block_sizes(void);
+void test_stack_pool_push_pop_n(void);
+void test_stack_pool_in_place(void);
+void test_stack_pool_last_error_per_thread(void);
+void test_stack_pool_unchecked(void);
+void test_stack_pool_events(void);
+void test_stack_pool_persistent(void);
+void test_stack_pool_spill(void);
+void test_stack_pool_reserved(void);
+void test_stack_pool_aligned(void);
+
+void test_stack_dyn_concurrent_init(void);
+void test_stack_dyn_concurrent_push_pop(void);
+void test_stack_dyn_concurrent_stress(void);
+void test_stack_dyn_concurrent_elimination(void);
+
+void test_stack_deque_init(void);
+void test_stack_deque_push_pop_steal(void);
+void test_stack_deque_large_blocks(void);
+void test_stack_deque_stress(void);
+
+void test_stack_pool_combining_init(void);
+void test_stack_pool_combining_push_pop(void);
+void test_stack_pool_combining_stress(void);
+void test_stack_pool_combining_accounting(void);
+
+void test_stack_pool_blocking_init(void);
+void test_stack_pool_blocking_timeout(void);
+void test_stack_pool_blocking_handoff(void);
+
+void test_stack_pool_shared_init(void);
+void test_stack_pool_shared_processes(void);
+
+void test_stack_stats_pool(void);
+void test_stack_stats_dyn(void);
+void test_stack_stats_dump(void);
+
+void test_stack_trace_pool(void);
+void test_stack_trace_dyn(void);
+
+void test_stack_arena(void);
+void test_stack_alloc_pool(void);
+void test_stack_alloc_dyn(void);
+
+void test_stack_intrusive_push_pop(void);
+void test_stack_intrusive_splice(void);
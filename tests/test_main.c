@@ -10,11 +10,73 @@ int main() {
     test_stack_dyn_init();
     test_stack_dyn_push_pop();
     test_stack_dyn_clear_is_empty();
+    test_stack_dyn_slab_reuse();
+    test_stack_dyn_chunked();
+    test_stack_dyn_push_pop_n();
+    test_stack_dyn_unchecked();
+    test_stack_dyn_events();
+    test_stack_dyn_sized();
     
     // Tests for stack with memory pool
     test_stack_pool_init();
     test_stack_pool_push_pop();
     test_stack_pool_clear_is_empty();
+    test_stack_pool_growth();
+    test_stack_pool_block_sizes();
+    test_stack_pool_push_pop_n();
+    test_stack_pool_in_place();
+    test_stack_pool_last_error_per_thread();
+    test_stack_pool_unchecked();
+    test_stack_pool_events();
+    test_stack_pool_persistent();
+    test_stack_pool_spill();
+    test_stack_pool_reserved();
+    test_stack_pool_aligned();
+    
+    // Tests for lock-free dynamic stack
+    test_stack_dyn_concurrent_init();
+    test_stack_dyn_concurrent_push_pop();
+    test_stack_dyn_concurrent_stress();
+    test_stack_dyn_concurrent_elimination();
+    
+    // Tests for work-stealing deque
+    test_stack_deque_init();
+    test_stack_deque_push_pop_steal();
+    test_stack_deque_large_blocks();
+    test_stack_deque_stress();
+    
+    // Tests for flat-combining stack
+    test_stack_pool_combining_init();
+    test_stack_pool_combining_push_pop();
+    test_stack_pool_combining_stress();
+    test_stack_pool_combining_accounting();
+    
+    // Tests for blocking stack
+    test_stack_pool_blocking_init();
+    test_stack_pool_blocking_timeout();
+    test_stack_pool_blocking_handoff();
+    
+    // Tests for stack shared between processes
+    test_stack_pool_shared_init();
+    test_stack_pool_shared_processes();
+    
+    // Tests for operation counters
+    test_stack_stats_pool();
+    test_stack_stats_dyn();
+    test_stack_stats_dump();
+    
+    // Tests for latency sampling
+    test_stack_trace_pool();
+    test_stack_trace_dyn();
+    
+    // Tests for pluggable allocators
+    test_stack_arena();
+    test_stack_alloc_pool();
+    test_stack_alloc_dyn();
+    
+    // Tests for intrusive stack
+    test_stack_intrusive_push_pop();
+    test_stack_intrusive_splice();
     
     printf("All tests passed successfully!\n");
     return 0;